@@ -0,0 +1,2436 @@
+// A Bison parser, made by GNU Bison 3.8.2.
+
+// Skeleton implementation for Bison LALR(1) parsers in C++
+
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// As a special exception, you may create a larger work that contains
+// part or all of the Bison parser skeleton and distribute that work
+// under terms of your choice, so long as that work isn't itself a
+// parser generator using the skeleton or a modified version thereof
+// as a parser skeleton.  Alternatively, if you modify or redistribute
+// the parser skeleton itself, you may (at your option) remove this
+// special exception, which will cause the skeleton and the resulting
+// Bison output files to be licensed under the GNU General Public
+// License without this special exception.
+
+// This special exception was added by the Free Software Foundation in
+// version 2.2 of Bison.
+
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
+
+
+
+
+#include "parser.hpp"
+
+
+// Unqualified %code blocks.
+#line 25 "src/parser.ypp"
+
+	#include "driver.hpp"
+	#include "report.hpp"
+	#define CONSTOP(res, i, l, r, op) res.type = statement_type::op; res.identifier = i; res.lhs = l; res.value = r;
+	#define VAROP(res, i, l, r, op) res.type = statement_type::op; res.identifier = i; res.lhs = l; res.rhs = r;
+
+	static expression_tree leaf(const std::string& identifier) {
+		return {.identifier = identifier};
+	}
+
+	static expression_tree leaf(unsigned value) {
+		return {.value = value};
+	}
+
+	// Build a binary operation, folding it if both operands are numbers.
+	static expression_tree binary(int type, expression_tree lhs, expression_tree rhs) {
+		if (lhs.is_number() && rhs.is_number()) {
+			unsigned l = lhs.value, r = rhs.value;
+			switch (type) {
+			case EQU: return leaf(l == r);
+			case NOT: return leaf(l != r);
+			case LT: return leaf(l < r);
+			case LTE: return leaf(l <= r);
+			case GT: return leaf(l > r);
+			case GTE: return leaf(l >= r);
+			case ADD: return leaf(l + r);
+			case SUB: return leaf(l - r);
+			case MULT: return leaf(l * r);
+			case DIV: if (r) return leaf(l / r); break;
+			case BAND: return leaf(l & r);
+			case BOR: return leaf(l | r);
+			case LOGICAL_AND: return leaf(l && r);
+			case LOGICAL_OR: return leaf(l || r);
+			}
+		}
+		return {.type = type, .operands = {lhs, rhs}};
+	}
+
+	// Convert an expression into a statement which stores it in `dest`, or
+	// into a condition if there is no destination. Expressions with a single
+	// operation become the simple operations that the compiler has always
+	// used, while anything larger is compiled as a whole.
+	static statement lower(const yy::location& l, const std::string& dest, const expression_tree& tree) {
+		statement stmt;
+		stmt.l = l;
+		if (tree.is_leaf() && dest.length()) {
+			if (tree.is_number()) {
+				CONSTOP(stmt, dest, dest, tree.value, ASSIGN);
+			} else {
+				VAROP(stmt, dest, dest, tree.identifier, COPY); // may load a global
+			}
+			return stmt;
+		}
+		if (tree.type == LOGICAL_AND || tree.type == LOGICAL_OR) {
+			if (dest.length()) {
+				stmt = {.type = EXPRESSION, .identifier = dest, .expression = {tree}, .l = l};
+			} else {
+				// Conditions short-circuit instead of calculating a value,
+				// unless that pass is disabled.
+				stmt.type = tree.type;
+				stmt.conditions = {lower(l, "", tree.operands[0]), lower(l, "", tree.operands[1])};
+				stmt.expression = {tree};
+			}
+			return stmt;
+		}
+		if (!tree.is_leaf()) {
+			const expression_tree& lhs = tree.operands[0];
+			const expression_tree& rhs = tree.operands[1];
+			if (lhs.is_leaf() && !lhs.is_number() && rhs.is_number()) {
+				stmt.type = tree.type - (EQU - CONST_EQU);
+				stmt.identifier = dest;
+				stmt.lhs = lhs.identifier;
+				stmt.value = rhs.value;
+				return stmt;
+			}
+			if (lhs.is_leaf() && !lhs.is_number() && rhs.is_leaf()) {
+				stmt.type = tree.type;
+				stmt.identifier = dest;
+				stmt.lhs = lhs.identifier;
+				stmt.rhs = rhs.identifier;
+				return stmt;
+			}
+		}
+		return {.type = EXPRESSION, .identifier = dest, .expression = {tree}, .l = l};
+	}
+
+#line 133 "obj/parser.cpp"
+
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> // FIXME: INFRINGES ON USER NAME SPACE.
+#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(msgid) msgid
+# endif
+#endif
+
+
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
+# else
+#  define YY_EXCEPTIONS 1
+# endif
+#endif
+
+#define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+# ifndef YYLLOC_DEFAULT
+#  define YYLLOC_DEFAULT(Current, Rhs, N)                               \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).begin  = YYRHSLOC (Rhs, 1).begin;                   \
+          (Current).end    = YYRHSLOC (Rhs, N).end;                     \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
+        }                                                               \
+    while (false)
+# endif
+
+
+// Enable debugging if requested.
+#if YYDEBUG
+
+// A pseudo ostream that takes yydebug_ into account.
+# define YYCDEBUG if (yydebug_) (*yycdebug_)
+
+# define YY_SYMBOL_PRINT(Title, Symbol)         \
+  do {                                          \
+    if (yydebug_)                               \
+    {                                           \
+      *yycdebug_ << Title << ' ';               \
+      yy_print_ (*yycdebug_, Symbol);           \
+      *yycdebug_ << '\n';                       \
+    }                                           \
+  } while (false)
+
+# define YY_REDUCE_PRINT(Rule)          \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_reduce_print_ (Rule);          \
+  } while (false)
+
+# define YY_STACK_PRINT()               \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_stack_print_ ();                \
+  } while (false)
+
+#else // !YYDEBUG
+
+# define YYCDEBUG if (false) std::cerr
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
+
+#endif // !YYDEBUG
+
+#define yyerrok         (yyerrstatus_ = 0)
+#define yyclearin       (yyla.clear ())
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYRECOVERING()  (!!yyerrstatus_)
+
+namespace yy {
+#line 225 "obj/parser.cpp"
+
+  /// Build a parser object.
+  parser::parser (driver& drv_yyarg)
+#if YYDEBUG
+    : yydebug_ (false),
+      yycdebug_ (&std::cerr),
+#else
+    :
+#endif
+      yy_lac_established_ (false),
+      drv (drv_yyarg)
+  {}
+
+  parser::~parser ()
+  {}
+
+  parser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
+  {}
+
+  /*---------.
+  | symbol.  |
+  `---------*/
+
+
+
+  // by_state.
+  parser::by_state::by_state () YY_NOEXCEPT
+    : state (empty_state)
+  {}
+
+  parser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
+  {}
+
+  void
+  parser::by_state::clear () YY_NOEXCEPT
+  {
+    state = empty_state;
+  }
+
+  void
+  parser::by_state::move (by_state& that)
+  {
+    state = that.state;
+    that.clear ();
+  }
+
+  parser::by_state::by_state (state_type s) YY_NOEXCEPT
+    : state (s)
+  {}
+
+  parser::symbol_kind_type
+  parser::by_state::kind () const YY_NOEXCEPT
+  {
+    if (state == empty_state)
+      return symbol_kind::S_YYEMPTY;
+    else
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
+  }
+
+  parser::stack_symbol_type::stack_symbol_type ()
+  {}
+
+  parser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument: // argument
+        value.YY_MOVE_OR_COPY< arg > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+        value.YY_MOVE_OR_COPY< def_pair > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.YY_MOVE_OR_COPY< expression_tree > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+      case symbol_kind::S_ARGID: // "$n"
+        value.YY_MOVE_OR_COPY< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_parameter: // parameter
+        value.YY_MOVE_OR_COPY< param > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_script: // script
+        value.YY_MOVE_OR_COPY< script > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_control: // control
+        value.YY_MOVE_OR_COPY< statement > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "identifier"
+      case symbol_kind::S_STRING: // "string"
+        value.YY_MOVE_OR_COPY< std::string > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_arguments: // arguments
+        value.YY_MOVE_OR_COPY< std::vector<arg> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declarations: // declarations
+        value.YY_MOVE_OR_COPY< std::vector<def_pair> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_parameters: // parameters
+        value.YY_MOVE_OR_COPY< std::vector<param> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_cases: // cases
+        value.YY_MOVE_OR_COPY< std::vector<statement> > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
+
+  parser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument: // argument
+        value.move< arg > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+        value.move< def_pair > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.move< expression_tree > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+      case symbol_kind::S_ARGID: // "$n"
+        value.move< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_parameter: // parameter
+        value.move< param > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_script: // script
+        value.move< script > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_control: // control
+        value.move< statement > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "identifier"
+      case symbol_kind::S_STRING: // "string"
+        value.move< std::string > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_arguments: // arguments
+        value.move< std::vector<arg> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_declarations: // declarations
+        value.move< std::vector<def_pair> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_parameters: // parameters
+        value.move< std::vector<param> > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_cases: // cases
+        value.move< std::vector<statement> > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+    // that is emptied.
+    that.kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+#if YY_CPLUSPLUS < 201103L
+  parser::stack_symbol_type&
+  parser::stack_symbol_type::operator= (const stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument: // argument
+        value.copy< arg > (that.value);
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+        value.copy< def_pair > (that.value);
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.copy< expression_tree > (that.value);
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+      case symbol_kind::S_ARGID: // "$n"
+        value.copy< int > (that.value);
+        break;
+
+      case symbol_kind::S_parameter: // parameter
+        value.copy< param > (that.value);
+        break;
+
+      case symbol_kind::S_script: // script
+        value.copy< script > (that.value);
+        break;
+
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_control: // control
+        value.copy< statement > (that.value);
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "identifier"
+      case symbol_kind::S_STRING: // "string"
+        value.copy< std::string > (that.value);
+        break;
+
+      case symbol_kind::S_arguments: // arguments
+        value.copy< std::vector<arg> > (that.value);
+        break;
+
+      case symbol_kind::S_declarations: // declarations
+        value.copy< std::vector<def_pair> > (that.value);
+        break;
+
+      case symbol_kind::S_parameters: // parameters
+        value.copy< std::vector<param> > (that.value);
+        break;
+
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_cases: // cases
+        value.copy< std::vector<statement> > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    return *this;
+  }
+
+  parser::stack_symbol_type&
+  parser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_argument: // argument
+        value.move< arg > (that.value);
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+        value.move< def_pair > (that.value);
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.move< expression_tree > (that.value);
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+      case symbol_kind::S_ARGID: // "$n"
+        value.move< int > (that.value);
+        break;
+
+      case symbol_kind::S_parameter: // parameter
+        value.move< param > (that.value);
+        break;
+
+      case symbol_kind::S_script: // script
+        value.move< script > (that.value);
+        break;
+
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_control: // control
+        value.move< statement > (that.value);
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "identifier"
+      case symbol_kind::S_STRING: // "string"
+        value.move< std::string > (that.value);
+        break;
+
+      case symbol_kind::S_arguments: // arguments
+        value.move< std::vector<arg> > (that.value);
+        break;
+
+      case symbol_kind::S_declarations: // declarations
+        value.move< std::vector<def_pair> > (that.value);
+        break;
+
+      case symbol_kind::S_parameters: // parameters
+        value.move< std::vector<param> > (that.value);
+        break;
+
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_cases: // cases
+        value.move< std::vector<statement> > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
+
+  template <typename Base>
+  void
+  parser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
+  {
+    if (yymsg)
+      YY_SYMBOL_PRINT (yymsg, yysym);
+  }
+
+#if YYDEBUG
+  template <typename Base>
+  void
+  parser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
+  {
+    std::ostream& yyoutput = yyo;
+    YY_USE (yyoutput);
+    if (yysym.empty ())
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        YY_USE (yykind);
+        yyo << ')';
+      }
+  }
+#endif
+
+  void
+  parser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
+  {
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
+  }
+
+  void
+  parser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
+  {
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
+  }
+
+  void
+  parser::yypop_ (int n) YY_NOEXCEPT
+  {
+    yystack_.pop (n);
+  }
+
+#if YYDEBUG
+  std::ostream&
+  parser::debug_stream () const
+  {
+    return *yycdebug_;
+  }
+
+  void
+  parser::set_debug_stream (std::ostream& o)
+  {
+    yycdebug_ = &o;
+  }
+
+
+  parser::debug_level_type
+  parser::debug_level () const
+  {
+    return yydebug_;
+  }
+
+  void
+  parser::set_debug_level (debug_level_type l)
+  {
+    yydebug_ = l;
+  }
+#endif // YYDEBUG
+
+  parser::state_type
+  parser::yy_lr_goto_state_ (state_type yystate, int yysym)
+  {
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
+    if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
+      return yytable_[yyr];
+    else
+      return yydefgoto_[yysym - YYNTOKENS];
+  }
+
+  bool
+  parser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yypact_ninf_;
+  }
+
+  bool
+  parser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yytable_ninf_;
+  }
+
+  int
+  parser::operator() ()
+  {
+    return parse ();
+  }
+
+  int
+  parser::parse ()
+  {
+    int yyn;
+    /// Length of the RHS of the rule being reduced.
+    int yylen = 0;
+
+    // Error handling.
+    int yynerrs_ = 0;
+    int yyerrstatus_ = 0;
+
+    /// The lookahead symbol.
+    symbol_type yyla;
+
+    /// The locations where the error started and ended.
+    stack_symbol_type yyerror_range[3];
+
+    /// The return value of parse ().
+    int yyresult;
+
+    // Discard the LAC context in case there still is one left from a
+    // previous invocation.
+    yy_lac_discard_ ("init");
+
+#if YY_EXCEPTIONS
+    try
+#endif // YY_EXCEPTIONS
+      {
+    YYCDEBUG << "Starting parse\n";
+
+
+    /* Initialize the stack.  The initial state will be set in
+       yynewstate, since the latter expects the semantical and the
+       location values to have been already stored, initialize these
+       stacks with a primary value.  */
+    yystack_.clear ();
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
+
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
+  yynewstate:
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
+
+    // Accept?
+    if (yystack_[0].state == yyfinal_)
+      YYACCEPT;
+
+    goto yybackup;
+
+
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
+    // Try to take a decision without lookahead.
+    yyn = yypact_[+yystack_[0].state];
+    if (yy_pact_value_is_default_ (yyn))
+      goto yydefault;
+
+    // Read a lookahead token.
+    if (yyla.empty ())
+      {
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
+        try
+#endif // YY_EXCEPTIONS
+          {
+            symbol_type yylookahead (yylex (drv));
+            yyla.move (yylookahead);
+          }
+#if YY_EXCEPTIONS
+        catch (const syntax_error& yyexc)
+          {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+            error (yyexc);
+            goto yyerrlab1;
+          }
+#endif // YY_EXCEPTIONS
+      }
+    YY_SYMBOL_PRINT ("Next token is", yyla);
+
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
+
+    /* If the proper action on seeing token YYLA.TYPE is to reduce or
+       to detect an error, take that action.  */
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        if (!yy_lac_establish_ (yyla.kind ()))
+          goto yyerrlab;
+        goto yydefault;
+      }
+
+    // Reduce or error.
+    yyn = yytable_[yyn];
+    if (yyn <= 0)
+      {
+        if (yy_table_value_is_error_ (yyn))
+          goto yyerrlab;
+        if (!yy_lac_establish_ (yyla.kind ()))
+          goto yyerrlab;
+
+        yyn = -yyn;
+        goto yyreduce;
+      }
+
+    // Count tokens shifted since error; after three, turn off error status.
+    if (yyerrstatus_)
+      --yyerrstatus_;
+
+    // Shift the lookahead token.
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
+    yy_lac_discard_ ("shift");
+    goto yynewstate;
+
+
+  /*-----------------------------------------------------------.
+  | yydefault -- do the default action for the current state.  |
+  `-----------------------------------------------------------*/
+  yydefault:
+    yyn = yydefact_[+yystack_[0].state];
+    if (yyn == 0)
+      goto yyerrlab;
+    goto yyreduce;
+
+
+  /*-----------------------------.
+  | yyreduce -- do a reduction.  |
+  `-----------------------------*/
+  yyreduce:
+    yylen = yyr2_[yyn];
+    {
+      stack_symbol_type yylhs;
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
+      /* Variants are always initialized to an empty instance of the
+         correct type. The default '$$ = $1' action is NOT applied
+         when using variants.  */
+      switch (yyr1_[yyn])
+    {
+      case symbol_kind::S_argument: // argument
+        yylhs.value.emplace< arg > ();
+        break;
+
+      case symbol_kind::S_declaration: // declaration
+        yylhs.value.emplace< def_pair > ();
+        break;
+
+      case symbol_kind::S_expression: // expression
+        yylhs.value.emplace< expression_tree > ();
+        break;
+
+      case symbol_kind::S_NUMBER: // "number"
+      case symbol_kind::S_ARGID: // "$n"
+        yylhs.value.emplace< int > ();
+        break;
+
+      case symbol_kind::S_parameter: // parameter
+        yylhs.value.emplace< param > ();
+        break;
+
+      case symbol_kind::S_script: // script
+        yylhs.value.emplace< script > ();
+        break;
+
+      case symbol_kind::S_statement: // statement
+      case symbol_kind::S_control: // control
+        yylhs.value.emplace< statement > ();
+        break;
+
+      case symbol_kind::S_IDENTIFIER: // "identifier"
+      case symbol_kind::S_STRING: // "string"
+        yylhs.value.emplace< std::string > ();
+        break;
+
+      case symbol_kind::S_arguments: // arguments
+        yylhs.value.emplace< std::vector<arg> > ();
+        break;
+
+      case symbol_kind::S_declarations: // declarations
+        yylhs.value.emplace< std::vector<def_pair> > ();
+        break;
+
+      case symbol_kind::S_parameters: // parameters
+        yylhs.value.emplace< std::vector<param> > ();
+        break;
+
+      case symbol_kind::S_statements: // statements
+      case symbol_kind::S_cases: // cases
+        yylhs.value.emplace< std::vector<statement> > ();
+        break;
+
+      default:
+        break;
+    }
+
+
+      // Default location.
+      {
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
+      }
+
+      // Perform the reduction.
+      YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
+      try
+#endif // YY_EXCEPTIONS
+        {
+          switch (yyn)
+            {
+  case 2: // file: blocks block
+#line 173 "src/parser.ypp"
+                   {}
+#line 890 "obj/parser.cpp"
+    break;
+
+  case 3: // blocks: %empty
+#line 174 "src/parser.ypp"
+               {}
+#line 896 "obj/parser.cpp"
+    break;
+
+  case 4: // blocks: blocks block
+#line 174 "src/parser.ypp"
+                                 {}
+#line 902 "obj/parser.cpp"
+    break;
+
+  case 5: // block: include
+#line 176 "src/parser.ypp"
+          {}
+#line 908 "obj/parser.cpp"
+    break;
+
+  case 6: // block: srcinc
+#line 177 "src/parser.ypp"
+         {}
+#line 914 "obj/parser.cpp"
+    break;
+
+  case 7: // block: typedef
+#line 178 "src/parser.ypp"
+          {}
+#line 920 "obj/parser.cpp"
+    break;
+
+  case 8: // block: environment
+#line 179 "src/parser.ypp"
+              {}
+#line 926 "obj/parser.cpp"
+    break;
+
+  case 9: // block: assembly
+#line 180 "src/parser.ypp"
+           {}
+#line 932 "obj/parser.cpp"
+    break;
+
+  case 10: // block: script
+#line 181 "src/parser.ypp"
+         {}
+#line 938 "obj/parser.cpp"
+    break;
+
+  case 11: // include: "include" "string" ";"
+#line 183 "src/parser.ypp"
+                                {
+	report::phase phase("include", yystack_[1].value.as < std::string > ());
+	FILE * cur_file = yyin;
+	driver new_driver;
+	new_driver.merge(drv);
+	new_driver.parse((std::filesystem::path(drv.file).parent_path() / yystack_[1].value.as < std::string > ()).string());
+	drv.merge(new_driver);
+	yyin = cur_file;
+}
+#line 952 "obj/parser.cpp"
+    break;
+
+  case 12: // srcinc: "include" "asm" "string" ";"
+#line 193 "src/parser.ypp"
+                                     {
+	drv.assembly.push_back(fmt::format("INCLUDE \"{}\"\n", yystack_[1].value.as < std::string > ()));
+}
+#line 960 "obj/parser.cpp"
+    break;
+
+  case 13: // typedef: "typedef" "identifier" "=" "number" ";"
+#line 198 "src/parser.ypp"
+                                          {
+	if (yystack_[1].value.as < int > () < 1 || yystack_[1].value.as < int > () > 4) {
+		err::fatal("Invalid size {} for type {}. Types must be from 1 to 4 bytes large", yystack_[3].value.as < std::string > (), yystack_[1].value.as < int > ());
+	}
+  drv.typedefs[yystack_[3].value.as < std::string > ()].size = yystack_[1].value.as < int > ();
+  }
+#line 971 "obj/parser.cpp"
+    break;
+
+  case 14: // typedef: "typedef" "identifier" "=" "identifier" ";"
+#line 204 "src/parser.ypp"
+                                              {
+  	drv.typedefs[yystack_[3].value.as < std::string > ()].size = drv.get_type(yystack_[1].value.as < std::string > ());
+  }
+#line 979 "obj/parser.cpp"
+    break;
+
+  case 15: // typedef: "typedef_big" "identifier" "=" "number" ";"
+#line 207 "src/parser.ypp"
+                                              {
+	if (yystack_[1].value.as < int > () < 1 || yystack_[1].value.as < int > () > 4) {
+		err::fatal("Invalid size {} for type {}. Types must be from 1 to 4 bytes large", yystack_[3].value.as < std::string > (), yystack_[1].value.as < int > ());
+	}
+	drv.typedefs[yystack_[3].value.as < std::string > ()].size = yystack_[1].value.as < int > ();
+	drv.typedefs[yystack_[3].value.as < std::string > ()].big_endian = true;
+}
+#line 991 "obj/parser.cpp"
+    break;
+
+  case 16: // typedef: "typedef_big" "identifier" "=" "identifier" ";"
+#line 214 "src/parser.ypp"
+                                                  {
+	drv.typedefs[yystack_[3].value.as < std::string > ()].size = drv.get_type(yystack_[1].value.as < std::string > ());
+	drv.typedefs[yystack_[3].value.as < std::string > ()].big_endian = true;
+}
+#line 1000 "obj/parser.cpp"
+    break;
+
+  case 17: // environment: "env" "identifier" "{" declarations "}"
+#line 219 "src/parser.ypp"
+                                                     {
+	environment& env = drv.environments[yystack_[3].value.as < std::string > ()];
+	for (auto& i : yystack_[1].value.as < std::vector<def_pair> > ()) {
+		if (i.is_terminator) {
+			env.terminator = i.value;
+		} else if (i.is_section) {
+			env.section = i.name;
+		} else if (i.is_pool) {
+			env.pool = i.value;
+		} else if (i.is_dispatch) {
+			if (i.name == "call") env.runtime.dispatch = dispatch_type::CALL;
+			else if (i.name == "threaded") env.runtime.dispatch = dispatch_type::THREADED;
+			else err::error("Unknown dispatch type \"{}\" in environment {}", i.name, yystack_[3].value.as < std::string > ());
+		} else if (i.is_layout) {
+			if (i.name == "manual") env.runtime.layout = table_layout::MANUAL;
+			else if (i.name == "interleaved") env.runtime.layout = table_layout::INTERLEAVED;
+			else if (i.name == "split") env.runtime.layout = table_layout::SPLIT;
+			else err::error("Unknown table layout \"{}\" in environment {}", i.name, yystack_[3].value.as < std::string > ());
+		} else if (i.is_pool_mode) {
+			if (i.name == "any") env.runtime.pool = pool_mode::ANY;
+			else if (i.name == "page") env.runtime.pool = pool_mode::PAGE;
+			else err::error("Unknown pool mode \"{}\" in environment {}", i.name, yystack_[3].value.as < std::string > ());
+		} else if (i.is_import) {
+			drv.import(i.name, env);
+		} else {
+			i.def.bytecode = env.bytecode_count++;
+			env.defines[i.name] = i.def;
+		}
+	}
+}
+#line 1035 "obj/parser.cpp"
+    break;
+
+  case 18: // declarations: %empty
+#line 249 "src/parser.ypp"
+                     {}
+#line 1041 "obj/parser.cpp"
+    break;
+
+  case 19: // declarations: declarations declaration
+#line 249 "src/parser.ypp"
+                                                   {
+	yystack_[1].value.as < std::vector<def_pair> > ().push_back(yystack_[0].value.as < def_pair > ()); yylhs.value.as < std::vector<def_pair> > () = yystack_[1].value.as < std::vector<def_pair> > ();
+}
+#line 1049 "obj/parser.cpp"
+    break;
+
+  case 20: // declaration: "def" "identifier" "(" parameters ")" ";"
+#line 253 "src/parser.ypp"
+                                            {
+	yylhs.value.as < def_pair > ().name = yystack_[4].value.as < std::string > ();
+	yylhs.value.as < def_pair > ().def.type = deftype::DEF;
+	yylhs.value.as < def_pair > ().def.parameters = yystack_[2].value.as < std::vector<param> > ();
+}
+#line 1059 "obj/parser.cpp"
+    break;
+
+  case 21: // declaration: "def" "identifier" "(" parameters ")" "=" "identifier" ";"
+#line 258 "src/parser.ypp"
+                                                             {
+	yylhs.value.as < def_pair > ().name = yystack_[6].value.as < std::string > ();
+	yylhs.value.as < def_pair > ().def.type = deftype::DEF;
+	yylhs.value.as < def_pair > ().def.parameters = yystack_[4].value.as < std::vector<param> > ();
+	yylhs.value.as < def_pair > ().def.handler = yystack_[1].value.as < std::string > ();
+}
+#line 1070 "obj/parser.cpp"
+    break;
+
+  case 22: // declaration: "mac" "identifier" "(" parameters ")" "=" "identifier" ";"
+#line 264 "src/parser.ypp"
+                                                             {
+	yylhs.value.as < def_pair > ().name = yystack_[6].value.as < std::string > ();
+	yylhs.value.as < def_pair > ().def.type = deftype::ALIAS;
+	yylhs.value.as < def_pair > ().def.alias = yystack_[1].value.as < std::string > ();
+	yylhs.value.as < def_pair > ().def.parameters = yystack_[4].value.as < std::vector<param> > ();
+}
+#line 1081 "obj/parser.cpp"
+    break;
+
+  case 23: // declaration: "mac" "identifier" "(" parameters ")" "=" "identifier" "(" arguments ")" ";"
+#line 270 "src/parser.ypp"
+                                                                               {
+	yylhs.value.as < def_pair > ().name = yystack_[9].value.as < std::string > ();
+	yylhs.value.as < def_pair > ().def.type = deftype::MAC;
+	yylhs.value.as < def_pair > ().def.parameters = yystack_[7].value.as < std::vector<param> > ();
+	yylhs.value.as < def_pair > ().def.alias = yystack_[4].value.as < std::string > ();
+	yylhs.value.as < def_pair > ().def.arguments = yystack_[2].value.as < std::vector<arg> > ();
+}
+#line 1093 "obj/parser.cpp"
+    break;
+
+  case 24: // declaration: "use" "identifier" ";"
+#line 277 "src/parser.ypp"
+                         { yylhs.value.as < def_pair > ().is_import = true; yylhs.value.as < def_pair > ().name = yystack_[1].value.as < std::string > (); }
+#line 1099 "obj/parser.cpp"
+    break;
+
+  case 25: // declaration: "terminator" "=" "number" ";"
+#line 278 "src/parser.ypp"
+                                { yylhs.value.as < def_pair > ().is_terminator = true; yylhs.value.as < def_pair > ().value = yystack_[1].value.as < int > (); }
+#line 1105 "obj/parser.cpp"
+    break;
+
+  case 26: // declaration: "section" "=" "string" ";"
+#line 279 "src/parser.ypp"
+                             { yylhs.value.as < def_pair > ().is_section = true; yylhs.value.as < def_pair > ().name = yystack_[1].value.as < std::string > (); }
+#line 1111 "obj/parser.cpp"
+    break;
+
+  case 27: // declaration: "pool" "=" "number" ";"
+#line 280 "src/parser.ypp"
+                          { yylhs.value.as < def_pair > ().is_pool = true; yylhs.value.as < def_pair > ().value = yystack_[1].value.as < int > (); }
+#line 1117 "obj/parser.cpp"
+    break;
+
+  case 28: // declaration: "dispatch" "=" "string" ";"
+#line 281 "src/parser.ypp"
+                              { yylhs.value.as < def_pair > ().is_dispatch = true; yylhs.value.as < def_pair > ().name = yystack_[1].value.as < std::string > (); }
+#line 1123 "obj/parser.cpp"
+    break;
+
+  case 29: // declaration: "table_layout" "=" "string" ";"
+#line 282 "src/parser.ypp"
+                                  { yylhs.value.as < def_pair > ().is_layout = true; yylhs.value.as < def_pair > ().name = yystack_[1].value.as < std::string > (); }
+#line 1129 "obj/parser.cpp"
+    break;
+
+  case 30: // declaration: "pool_mode" "=" "string" ";"
+#line 283 "src/parser.ypp"
+                               { yylhs.value.as < def_pair > ().is_pool_mode = true; yylhs.value.as < def_pair > ().name = yystack_[1].value.as < std::string > (); }
+#line 1135 "obj/parser.cpp"
+    break;
+
+  case 31: // script: "identifier" "identifier" "{" statements "}"
+#line 286 "src/parser.ypp"
+                                               {
+  	drv.scripts[yystack_[3].value.as < std::string > ()].statements = yystack_[1].value.as < std::vector<statement> > ();
+  	drv.scripts[yystack_[3].value.as < std::string > ()].env = yystack_[4].value.as < std::string > ();
+}
+#line 1144 "obj/parser.cpp"
+    break;
+
+  case 32: // script: "native" "identifier" "identifier" "{" statements "}"
+#line 290 "src/parser.ypp"
+                                                        {
+  	drv.scripts[yystack_[3].value.as < std::string > ()].statements = yystack_[1].value.as < std::vector<statement> > ();
+  	drv.scripts[yystack_[3].value.as < std::string > ()].env = yystack_[4].value.as < std::string > ();
+  	drv.scripts[yystack_[3].value.as < std::string > ()].native = true;
+}
+#line 1154 "obj/parser.cpp"
+    break;
+
+  case 33: // statements: %empty
+#line 296 "src/parser.ypp"
+                   {}
+#line 1160 "obj/parser.cpp"
+    break;
+
+  case 34: // statements: statements statement ";"
+#line 297 "src/parser.ypp"
+                           {
+	yystack_[1].value.as < statement > ().l = yystack_[1].location;
+	yystack_[2].value.as < std::vector<statement> > ().push_back(yystack_[1].value.as < statement > ());
+	yylhs.value.as < std::vector<statement> > () = yystack_[2].value.as < std::vector<statement> > ();
+}
+#line 1170 "obj/parser.cpp"
+    break;
+
+  case 35: // statements: statements "identifier" ":"
+#line 302 "src/parser.ypp"
+                              {
+	statement stmt = {.type = statement_type::LABEL, .identifier = yystack_[1].value.as < std::string > (), .l = yystack_[1].location};
+	yystack_[2].value.as < std::vector<statement> > ().push_back(stmt);
+	yylhs.value.as < std::vector<statement> > () = yystack_[2].value.as < std::vector<statement> > ();
+}
+#line 1180 "obj/parser.cpp"
+    break;
+
+  case 36: // statements: statements control
+#line 307 "src/parser.ypp"
+                     {
+	yystack_[0].value.as < statement > ().l = yystack_[0].location;
+	yystack_[1].value.as < std::vector<statement> > ().push_back(yystack_[0].value.as < statement > ());
+	yylhs.value.as < std::vector<statement> > () = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1190 "obj/parser.cpp"
+    break;
+
+  case 37: // statement: "{" statement "}"
+#line 314 "src/parser.ypp"
+                    { yylhs.value.as < statement > () = yystack_[1].value.as < statement > (); }
+#line 1196 "obj/parser.cpp"
+    break;
+
+  case 38: // statement: expression
+#line 315 "src/parser.ypp"
+             { yylhs.value.as < statement > () = lower(yylhs.location, "", yystack_[0].value.as < expression_tree > ()); }
+#line 1202 "obj/parser.cpp"
+    break;
+
+  case 39: // statement: "identifier" "(" arguments ")"
+#line 316 "src/parser.ypp"
+                                 {
+	yylhs.value.as < statement > ().type = statement_type::CALL;
+	yylhs.value.as < statement > ().identifier = yystack_[3].value.as < std::string > ();
+	yylhs.value.as < statement > ().args = yystack_[1].value.as < std::vector<arg> > ();
+}
+#line 1212 "obj/parser.cpp"
+    break;
+
+  case 40: // statement: "identifier" "=" expression
+#line 321 "src/parser.ypp"
+                              { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1218 "obj/parser.cpp"
+    break;
+
+  case 41: // statement: "identifier" "+=" expression
+#line 322 "src/parser.ypp"
+                               { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), binary(ADD, leaf(yystack_[2].value.as < std::string > ()), yystack_[0].value.as < expression_tree > ())); }
+#line 1224 "obj/parser.cpp"
+    break;
+
+  case 42: // statement: "identifier" "-=" expression
+#line 323 "src/parser.ypp"
+                               { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), binary(SUB, leaf(yystack_[2].value.as < std::string > ()), yystack_[0].value.as < expression_tree > ())); }
+#line 1230 "obj/parser.cpp"
+    break;
+
+  case 43: // statement: "identifier" "*=" expression
+#line 324 "src/parser.ypp"
+                               { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), binary(MULT, leaf(yystack_[2].value.as < std::string > ()), yystack_[0].value.as < expression_tree > ())); }
+#line 1236 "obj/parser.cpp"
+    break;
+
+  case 44: // statement: "identifier" "/=" expression
+#line 325 "src/parser.ypp"
+                               { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), binary(DIV, leaf(yystack_[2].value.as < std::string > ()), yystack_[0].value.as < expression_tree > ())); }
+#line 1242 "obj/parser.cpp"
+    break;
+
+  case 45: // statement: "identifier" "&=" expression
+#line 326 "src/parser.ypp"
+                               { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), binary(BAND, leaf(yystack_[2].value.as < std::string > ()), yystack_[0].value.as < expression_tree > ())); }
+#line 1248 "obj/parser.cpp"
+    break;
+
+  case 46: // statement: "identifier" "|=" expression
+#line 327 "src/parser.ypp"
+                               { yylhs.value.as < statement > () = lower(yylhs.location, yystack_[2].value.as < std::string > (), binary(BOR, leaf(yystack_[2].value.as < std::string > ()), yystack_[0].value.as < expression_tree > ())); }
+#line 1254 "obj/parser.cpp"
+    break;
+
+  case 47: // statement: "identifier" "identifier"
+#line 328 "src/parser.ypp"
+                            {
+	yylhs.value.as < statement > ().type = statement_type::DECLARE;
+	yylhs.value.as < statement > ().size = drv.get_type(yystack_[1].value.as < std::string > ());
+	yylhs.value.as < statement > ().identifier = yystack_[0].value.as < std::string > ();
+}
+#line 1264 "obj/parser.cpp"
+    break;
+
+  case 48: // statement: "identifier" "identifier" "=" expression
+#line 334 "src/parser.ypp"
+                                           {
+	yylhs.value.as < statement > ().size = drv.get_type(yystack_[3].value.as < std::string > ());
+	yylhs.value.as < statement > ().identifier = yystack_[2].value.as < std::string > ();
+	yylhs.value.as < statement > ().lhs = yystack_[2].value.as < std::string > ();
+	if (yystack_[0].value.as < expression_tree > ().is_number()) {
+		yylhs.value.as < statement > ().type = statement_type::DECLARE_ASSIGN;
+		yylhs.value.as < statement > ().value = yystack_[0].value.as < expression_tree > ().value;
+	} else if (yystack_[0].value.as < expression_tree > ().is_leaf()) {
+		yylhs.value.as < statement > ().type = statement_type::DECLARE_COPY;
+		yylhs.value.as < statement > ().rhs = yystack_[0].value.as < expression_tree > ().identifier;
+	} else {
+		// The expression is compiled once the variable exists.
+		yylhs.value.as < statement > ().type = statement_type::DECLARE;
+		yylhs.value.as < statement > ().statements.push_back(lower(yylhs.location, yystack_[2].value.as < std::string > (), yystack_[0].value.as < expression_tree > ()));
+	}
+}
+#line 1285 "obj/parser.cpp"
+    break;
+
+  case 49: // statement: "drop" "identifier"
+#line 350 "src/parser.ypp"
+                      { yylhs.value.as < statement > ().type = statement_type::DROP; yylhs.value.as < statement > ().identifier = yystack_[0].value.as < std::string > (); }
+#line 1291 "obj/parser.cpp"
+    break;
+
+  case 50: // statement: "break"
+#line 351 "src/parser.ypp"
+          { yylhs.value.as < statement > ().type = statement_type::BREAK; }
+#line 1297 "obj/parser.cpp"
+    break;
+
+  case 51: // statement: "continue"
+#line 352 "src/parser.ypp"
+             { yylhs.value.as < statement > ().type = statement_type::CONTINUE; }
+#line 1303 "obj/parser.cpp"
+    break;
+
+  case 52: // statement: "return"
+#line 353 "src/parser.ypp"
+           { yylhs.value.as < statement > ().type = statement_type::CALL; yylhs.value.as < statement > ().identifier = "return"; }
+#line 1309 "obj/parser.cpp"
+    break;
+
+  case 53: // statement: "yield"
+#line 354 "src/parser.ypp"
+          { yylhs.value.as < statement > ().type = statement_type::CALL; yylhs.value.as < statement > ().identifier = "yield"; }
+#line 1315 "obj/parser.cpp"
+    break;
+
+  case 54: // statement: "goto" "identifier"
+#line 356 "src/parser.ypp"
+                      { yylhs.value.as < statement > ().type = statement_type::GOTO; yylhs.value.as < statement > ().identifier = yystack_[0].value.as < std::string > (); }
+#line 1321 "obj/parser.cpp"
+    break;
+
+  case 55: // statement: "call" "identifier"
+#line 357 "src/parser.ypp"
+                      { yylhs.value.as < statement > ().type = statement_type::CALLASM; yylhs.value.as < statement > ().identifier = yystack_[0].value.as < std::string > (); }
+#line 1327 "obj/parser.cpp"
+    break;
+
+  case 56: // expression: "identifier"
+#line 364 "src/parser.ypp"
+               { yylhs.value.as < expression_tree > () = leaf(yystack_[0].value.as < std::string > ()); }
+#line 1333 "obj/parser.cpp"
+    break;
+
+  case 57: // expression: "number"
+#line 365 "src/parser.ypp"
+           { yylhs.value.as < expression_tree > () = leaf((unsigned) yystack_[0].value.as < int > ()); }
+#line 1339 "obj/parser.cpp"
+    break;
+
+  case 58: // expression: "(" expression ")"
+#line 366 "src/parser.ypp"
+                     { yylhs.value.as < expression_tree > () = yystack_[1].value.as < expression_tree > (); }
+#line 1345 "obj/parser.cpp"
+    break;
+
+  case 59: // expression: expression "+" expression
+#line 367 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(ADD, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1351 "obj/parser.cpp"
+    break;
+
+  case 60: // expression: expression "-" expression
+#line 368 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(SUB, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1357 "obj/parser.cpp"
+    break;
+
+  case 61: // expression: expression "*" expression
+#line 369 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(MULT, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1363 "obj/parser.cpp"
+    break;
+
+  case 62: // expression: expression "/" expression
+#line 370 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(DIV, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1369 "obj/parser.cpp"
+    break;
+
+  case 63: // expression: expression "&" expression
+#line 371 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(BAND, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1375 "obj/parser.cpp"
+    break;
+
+  case 64: // expression: expression "|" expression
+#line 372 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(BOR, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1381 "obj/parser.cpp"
+    break;
+
+  case 65: // expression: expression "==" expression
+#line 373 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(EQU, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1387 "obj/parser.cpp"
+    break;
+
+  case 66: // expression: expression "!=" expression
+#line 374 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(NOT, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1393 "obj/parser.cpp"
+    break;
+
+  case 67: // expression: expression "<" expression
+#line 375 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(LT, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1399 "obj/parser.cpp"
+    break;
+
+  case 68: // expression: expression "<=" expression
+#line 376 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(LTE, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1405 "obj/parser.cpp"
+    break;
+
+  case 69: // expression: expression ">" expression
+#line 377 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(GT, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1411 "obj/parser.cpp"
+    break;
+
+  case 70: // expression: expression ">=" expression
+#line 378 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(GTE, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1417 "obj/parser.cpp"
+    break;
+
+  case 71: // expression: expression "&&" expression
+#line 379 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(LOGICAL_AND, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1423 "obj/parser.cpp"
+    break;
+
+  case 72: // expression: expression "||" expression
+#line 380 "src/parser.ypp"
+                             { yylhs.value.as < expression_tree > () = binary(LOGICAL_OR, yystack_[2].value.as < expression_tree > (), yystack_[0].value.as < expression_tree > ()); }
+#line 1429 "obj/parser.cpp"
+    break;
+
+  case 73: // control: "if" statement "{" statements "}"
+#line 385 "src/parser.ypp"
+                                    {
+	yylhs.value.as < statement > ().type = statement_type::IF;
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[3].value.as < statement > ());
+	yylhs.value.as < statement > ().statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1439 "obj/parser.cpp"
+    break;
+
+  case 74: // control: "if" statement "{" statements "}" "else" "{" statements "}"
+#line 390 "src/parser.ypp"
+                                                              {
+	yylhs.value.as < statement > ().type = statement_type::IF;
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[7].value.as < statement > ());
+	yylhs.value.as < statement > ().statements = yystack_[5].value.as < std::vector<statement> > ();
+	yylhs.value.as < statement > ().else_statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1450 "obj/parser.cpp"
+    break;
+
+  case 75: // control: "if" statement "{" statements "}" "else" control
+#line 396 "src/parser.ypp"
+                                                   {
+	yylhs.value.as < statement > ().type = statement_type::IF;
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[5].value.as < statement > ());
+	yylhs.value.as < statement > ().statements = yystack_[3].value.as < std::vector<statement> > ();
+	yylhs.value.as < statement > ().else_statements.push_back(yystack_[0].value.as < statement > ());
+}
+#line 1461 "obj/parser.cpp"
+    break;
+
+  case 76: // control: "while" statement "{" statements "}"
+#line 402 "src/parser.ypp"
+                                       {
+	yylhs.value.as < statement > ().type = statement_type::WHILE;
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[3].value.as < statement > ());
+	yylhs.value.as < statement > ().statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1471 "obj/parser.cpp"
+    break;
+
+  case 77: // control: "do" "{" statements "}" "while" expression
+#line 409 "src/parser.ypp"
+                                             {
+	yylhs.value.as < statement > ().type = statement_type::DO;
+	yylhs.value.as < statement > ().conditions.push_back(lower(yylhs.location, "", yystack_[0].value.as < expression_tree > ()));
+	yylhs.value.as < statement > ().statements = yystack_[3].value.as < std::vector<statement> > ();
+}
+#line 1481 "obj/parser.cpp"
+    break;
+
+  case 78: // control: "for" statement ";" statement ";" statement "{" statements "}"
+#line 414 "src/parser.ypp"
+                                                                  {
+	yylhs.value.as < statement > ().type = statement_type::FOR;
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[7].value.as < statement > ());
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[5].value.as < statement > ());
+	yylhs.value.as < statement > ().conditions.push_back(yystack_[3].value.as < statement > ());
+	yylhs.value.as < statement > ().statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1493 "obj/parser.cpp"
+    break;
+
+  case 79: // control: "repeat" "number" "{" statements "}"
+#line 421 "src/parser.ypp"
+                                       {
+	yylhs.value.as < statement > ().type = statement_type::REPEAT;
+	yylhs.value.as < statement > ().value = yystack_[3].value.as < int > ();
+	yylhs.value.as < statement > ().statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1503 "obj/parser.cpp"
+    break;
+
+  case 80: // control: "loop" "{" statements "}"
+#line 426 "src/parser.ypp"
+                            {
+	yylhs.value.as < statement > ().type = statement_type::LOOP;
+	yylhs.value.as < statement > ().statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1512 "obj/parser.cpp"
+    break;
+
+  case 81: // control: "switch" "identifier" "{" cases "}"
+#line 430 "src/parser.ypp"
+                                      {
+	yylhs.value.as < statement > ().type = statement_type::SWITCH;
+	yylhs.value.as < statement > ().identifier = yystack_[3].value.as < std::string > ();
+	yylhs.value.as < statement > ().statements = yystack_[1].value.as < std::vector<statement> > ();
+}
+#line 1522 "obj/parser.cpp"
+    break;
+
+  case 82: // cases: %empty
+#line 438 "src/parser.ypp"
+         {}
+#line 1528 "obj/parser.cpp"
+    break;
+
+  case 83: // cases: cases "case" "number" "{" statements "}"
+#line 439 "src/parser.ypp"
+                                           {
+	statement c = {.type = statement_type::CASE, .statements = yystack_[1].value.as < std::vector<statement> > (), .value = (unsigned) yystack_[3].value.as < int > (), .l = yystack_[4].location};
+	yystack_[5].value.as < std::vector<statement> > ().push_back(c);
+	yylhs.value.as < std::vector<statement> > () = yystack_[5].value.as < std::vector<statement> > ();
+}
+#line 1538 "obj/parser.cpp"
+    break;
+
+  case 84: // cases: cases "default" "{" statements "}"
+#line 444 "src/parser.ypp"
+                                     {
+	statement c = {.type = statement_type::NOOP, .statements = yystack_[1].value.as < std::vector<statement> > (), .l = yystack_[3].location};
+	yystack_[4].value.as < std::vector<statement> > ().push_back(c);
+	yylhs.value.as < std::vector<statement> > () = yystack_[4].value.as < std::vector<statement> > ();
+}
+#line 1548 "obj/parser.cpp"
+    break;
+
+  case 85: // parameters: %empty
+#line 451 "src/parser.ypp"
+         {}
+#line 1554 "obj/parser.cpp"
+    break;
+
+  case 86: // parameters: parameter
+#line 452 "src/parser.ypp"
+            { yylhs.value.as < std::vector<param> > ().push_back(yystack_[0].value.as < param > ()); }
+#line 1560 "obj/parser.cpp"
+    break;
+
+  case 87: // parameters: parameters "," parameter
+#line 453 "src/parser.ypp"
+                           { yystack_[2].value.as < std::vector<param> > ().push_back(yystack_[0].value.as < param > ()); yylhs.value.as < std::vector<param> > () = yystack_[2].value.as < std::vector<param> > (); }
+#line 1566 "obj/parser.cpp"
+    break;
+
+  case 88: // parameter: "identifier"
+#line 456 "src/parser.ypp"
+               { yylhs.value.as < param > ().type = partype::ARG; yylhs.value.as < param > ().size = drv.get_type(yystack_[0].value.as < std::string > ()); }
+#line 1572 "obj/parser.cpp"
+    break;
+
+  case 89: // parameter: "const" "identifier"
+#line 457 "src/parser.ypp"
+                       { yylhs.value.as < param > ().type = partype::CON; yylhs.value.as < param > ().size = drv.get_type(yystack_[0].value.as < std::string > ()); }
+#line 1578 "obj/parser.cpp"
+    break;
+
+  case 90: // parameter: "..."
+#line 458 "src/parser.ypp"
+        { yylhs.value.as < param > ().type = partype::VARARGS; }
+#line 1584 "obj/parser.cpp"
+    break;
+
+  case 91: // arguments: %empty
+#line 461 "src/parser.ypp"
+         {}
+#line 1590 "obj/parser.cpp"
+    break;
+
+  case 92: // arguments: argument
+#line 462 "src/parser.ypp"
+           { yylhs.value.as < std::vector<arg> > ().push_back(yystack_[0].value.as < arg > ()); }
+#line 1596 "obj/parser.cpp"
+    break;
+
+  case 93: // arguments: arguments "," argument
+#line 463 "src/parser.ypp"
+                         { yystack_[2].value.as < std::vector<arg> > ().push_back(yystack_[0].value.as < arg > ()); yylhs.value.as < std::vector<arg> > () = yystack_[2].value.as < std::vector<arg> > (); }
+#line 1602 "obj/parser.cpp"
+    break;
+
+  case 94: // argument: "identifier"
+#line 465 "src/parser.ypp"
+               { yylhs.value.as < arg > ().str = yystack_[0].value.as < std::string > (); yylhs.value.as < arg > ().type = argtype::VAR; }
+#line 1608 "obj/parser.cpp"
+    break;
+
+  case 95: // argument: "number"
+#line 466 "src/parser.ypp"
+           { yylhs.value.as < arg > ().value = yystack_[0].value.as < int > (); yylhs.value.as < arg > ().type = argtype::NUM; }
+#line 1614 "obj/parser.cpp"
+    break;
+
+  case 96: // argument: "string"
+#line 467 "src/parser.ypp"
+           { yylhs.value.as < arg > ().str = yystack_[0].value.as < std::string > (); yylhs.value.as < arg > ().type = argtype::STR; }
+#line 1620 "obj/parser.cpp"
+    break;
+
+  case 97: // argument: "$n"
+#line 468 "src/parser.ypp"
+       { yylhs.value.as < arg > ().value = yystack_[0].value.as < int > (); yylhs.value.as < arg > ().type = argtype::ARG; }
+#line 1626 "obj/parser.cpp"
+    break;
+
+  case 98: // assembly: "asm" "string"
+#line 470 "src/parser.ypp"
+                         { drv.assembly.push_back(yystack_[0].value.as < std::string > ()); }
+#line 1632 "obj/parser.cpp"
+    break;
+
+
+#line 1636 "obj/parser.cpp"
+
+            default:
+              break;
+            }
+        }
+#if YY_EXCEPTIONS
+      catch (const syntax_error& yyexc)
+        {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+          error (yyexc);
+          YYERROR;
+        }
+#endif // YY_EXCEPTIONS
+      YY_SYMBOL_PRINT ("-> $$ =", yylhs);
+      yypop_ (yylen);
+      yylen = 0;
+
+      // Shift the result of the reduction.
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
+    }
+    goto yynewstate;
+
+
+  /*--------------------------------------.
+  | yyerrlab -- here on detecting error.  |
+  `--------------------------------------*/
+  yyerrlab:
+    // If not already recovering from an error, report this error.
+    if (!yyerrstatus_)
+      {
+        ++yynerrs_;
+        context yyctx (*this, yyla);
+        std::string msg = yysyntax_error_ (yyctx);
+        error (yyla.location, YY_MOVE (msg));
+      }
+
+
+    yyerror_range[1].location = yyla.location;
+    if (yyerrstatus_ == 3)
+      {
+        /* If just tried and failed to reuse lookahead token after an
+           error, discard it.  */
+
+        // Return failure if at end of input.
+        if (yyla.kind () == symbol_kind::S_YYEOF)
+          YYABORT;
+        else if (!yyla.empty ())
+          {
+            yy_destroy_ ("Error: discarding", yyla);
+            yyla.clear ();
+          }
+      }
+
+    // Else will try to reuse lookahead token after shifting the error token.
+    goto yyerrlab1;
+
+
+  /*---------------------------------------------------.
+  | yyerrorlab -- error raised explicitly by YYERROR.  |
+  `---------------------------------------------------*/
+  yyerrorlab:
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
+    if (false)
+      YYERROR;
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYERROR.  */
+    yypop_ (yylen);
+    yylen = 0;
+    YY_STACK_PRINT ();
+    goto yyerrlab1;
+
+
+  /*-------------------------------------------------------------.
+  | yyerrlab1 -- common code for both syntax error and YYERROR.  |
+  `-------------------------------------------------------------*/
+  yyerrlab1:
+    yyerrstatus_ = 3;   // Each real token shifted decrements this.
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
+              {
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
+              }
+          }
+
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
+
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
+    {
+      stack_symbol_type error_token;
+
+      yyerror_range[2].location = yyla.location;
+      YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
+
+      // Shift the error token.
+      yy_lac_discard_ ("error recovery");
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
+    }
+    goto yynewstate;
+
+
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
+  yyacceptlab:
+    yyresult = 0;
+    goto yyreturn;
+
+
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
+  yyabortlab:
+    yyresult = 1;
+    goto yyreturn;
+
+
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
+  yyreturn:
+    if (!yyla.empty ())
+      yy_destroy_ ("Cleanup: discarding lookahead", yyla);
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYABORT or YYACCEPT.  */
+    yypop_ (yylen);
+    YY_STACK_PRINT ();
+    while (1 < yystack_.size ())
+      {
+        yy_destroy_ ("Cleanup: popping", yystack_[0]);
+        yypop_ ();
+      }
+
+    return yyresult;
+  }
+#if YY_EXCEPTIONS
+    catch (...)
+      {
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
+        // Do not try to display the values of the reclaimed symbols,
+        // as their printers might throw an exception.
+        if (!yyla.empty ())
+          yy_destroy_ (YY_NULLPTR, yyla);
+
+        while (1 < yystack_.size ())
+          {
+            yy_destroy_ (YY_NULLPTR, yystack_[0]);
+            yypop_ ();
+          }
+        throw;
+      }
+#endif // YY_EXCEPTIONS
+  }
+
+  void
+  parser::error (const syntax_error& yyexc)
+  {
+    error (yyexc.location, yyexc.what ());
+  }
+
+  const char *
+  parser::symbol_name (symbol_kind_type yysymbol)
+  {
+    static const char *const yy_sname[] =
+    {
+    "end of file", "error", "invalid token", "=", "+", "-", "*", "/", "&",
+  "|", "+=", "-=", "*=", "/=", "&=", "|=", "&&", "||", "==", "!=", "<",
+  "<=", ">", ">=", "(", ")", "{", "}", ":", "...", ";", ",", "env", "asm",
+  "def", "mac", "use", "terminator", "section", "pool", "dispatch",
+  "table_layout", "pool_mode", "const", "typedef", "typedef_big", "drop",
+  "include", "if", "else", "while", "do", "for", "repeat", "loop",
+  "switch", "case", "default", "break", "continue", "return", "yield",
+  "goto", "call", "native", "identifier", "number", "$n", "string",
+  "$accept", "file", "blocks", "block", "include", "srcinc", "typedef",
+  "environment", "declarations", "declaration", "script", "statements",
+  "statement", "expression", "control", "cases", "parameters", "parameter",
+  "arguments", "argument", "assembly", YY_NULLPTR
+    };
+    return yy_sname[yysymbol];
+  }
+
+
+
+  // parser::context.
+  parser::context::context (const parser& yyparser, const symbol_type& yyla)
+    : yyparser_ (yyparser)
+    , yyla_ (yyla)
+  {}
+
+  int
+  parser::context::expected_tokens (symbol_kind_type yyarg[], int yyargn) const
+  {
+    // Actual number of expected tokens
+    int yycount = 0;
+
+#if YYDEBUG
+    // Execute LAC once. We don't care if it is successful, we
+    // only do it for the sake of debugging output.
+    if (!yyparser_.yy_lac_established_)
+      yyparser_.yy_lac_check_ (yyla_.kind ());
+#endif
+
+    for (int yyx = 0; yyx < YYNTOKENS; ++yyx)
+      {
+        symbol_kind_type yysym = YY_CAST (symbol_kind_type, yyx);
+        if (yysym != symbol_kind::S_YYerror
+            && yysym != symbol_kind::S_YYUNDEF
+            && yyparser_.yy_lac_check_ (yysym))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = yysym;
+          }
+      }
+    if (yyarg && yycount == 0 && 0 < yyargn)
+      yyarg[0] = symbol_kind::S_YYEMPTY;
+    return yycount;
+  }
+
+
+
+
+  bool
+  parser::yy_lac_check_ (symbol_kind_type yytoken) const
+  {
+    // Logically, the yylac_stack's lifetime is confined to this function.
+    // Clear it, to get rid of potential left-overs from previous call.
+    yylac_stack_.clear ();
+    // Reduce until we encounter a shift and thereby accept the token.
+#if YYDEBUG
+    YYCDEBUG << "LAC: checking lookahead " << symbol_name (yytoken) << ':';
+#endif
+    std::ptrdiff_t lac_top = 0;
+    while (true)
+      {
+        state_type top_state = (yylac_stack_.empty ()
+                                ? yystack_[lac_top].state
+                                : yylac_stack_.back ());
+        int yyrule = yypact_[+top_state];
+        if (yy_pact_value_is_default_ (yyrule)
+            || (yyrule += yytoken) < 0 || yylast_ < yyrule
+            || yycheck_[yyrule] != yytoken)
+          {
+            // Use the default action.
+            yyrule = yydefact_[+top_state];
+            if (yyrule == 0)
+              {
+                YYCDEBUG << " Err\n";
+                return false;
+              }
+          }
+        else
+          {
+            // Use the action from yytable.
+            yyrule = yytable_[yyrule];
+            if (yy_table_value_is_error_ (yyrule))
+              {
+                YYCDEBUG << " Err\n";
+                return false;
+              }
+            if (0 < yyrule)
+              {
+                YYCDEBUG << " S" << yyrule << '\n';
+                return true;
+              }
+            yyrule = -yyrule;
+          }
+        // By now we know we have to simulate a reduce.
+        YYCDEBUG << " R" << yyrule - 1;
+        // Pop the corresponding number of values from the stack.
+        {
+          std::ptrdiff_t yylen = yyr2_[yyrule];
+          // First pop from the LAC stack as many tokens as possible.
+          std::ptrdiff_t lac_size = std::ptrdiff_t (yylac_stack_.size ());
+          if (yylen < lac_size)
+            {
+              yylac_stack_.resize (std::size_t (lac_size - yylen));
+              yylen = 0;
+            }
+          else if (lac_size)
+            {
+              yylac_stack_.clear ();
+              yylen -= lac_size;
+            }
+          // Only afterwards look at the main stack.
+          // We simulate popping elements by incrementing lac_top.
+          lac_top += yylen;
+        }
+        // Keep top_state in sync with the updated stack.
+        top_state = (yylac_stack_.empty ()
+                     ? yystack_[lac_top].state
+                     : yylac_stack_.back ());
+        // Push the resulting state of the reduction.
+        state_type state = yy_lr_goto_state_ (top_state, yyr1_[yyrule]);
+        YYCDEBUG << " G" << int (state);
+        yylac_stack_.push_back (state);
+      }
+  }
+
+  // Establish the initial context if no initial context currently exists.
+  bool
+  parser::yy_lac_establish_ (symbol_kind_type yytoken)
+  {
+    /* Establish the initial context for the current lookahead if no initial
+       context is currently established.
+
+       We define a context as a snapshot of the parser stacks.  We define
+       the initial context for a lookahead as the context in which the
+       parser initially examines that lookahead in order to select a
+       syntactic action.  Thus, if the lookahead eventually proves
+       syntactically unacceptable (possibly in a later context reached via a
+       series of reductions), the initial context can be used to determine
+       the exact set of tokens that would be syntactically acceptable in the
+       lookahead's place.  Moreover, it is the context after which any
+       further semantic actions would be erroneous because they would be
+       determined by a syntactically unacceptable token.
+
+       yy_lac_establish_ should be invoked when a reduction is about to be
+       performed in an inconsistent state (which, for the purposes of LAC,
+       includes consistent states that don't know they're consistent because
+       their default reductions have been disabled).
+
+       For parse.lac=full, the implementation of yy_lac_establish_ is as
+       follows.  If no initial context is currently established for the
+       current lookahead, then check if that lookahead can eventually be
+       shifted if syntactic actions continue from the current context.  */
+    if (yy_lac_established_)
+      return true;
+    else
+      {
+#if YYDEBUG
+        YYCDEBUG << "LAC: initial context established for "
+                 << symbol_name (yytoken) << '\n';
+#endif
+        yy_lac_established_ = true;
+        return yy_lac_check_ (yytoken);
+      }
+  }
+
+  // Discard any previous initial lookahead context.
+  void
+  parser::yy_lac_discard_ (const char* event)
+  {
+   /* Discard any previous initial lookahead context because of Event,
+      which may be a lookahead change or an invalidation of the currently
+      established initial context for the current lookahead.
+
+      The most common example of a lookahead change is a shift.  An example
+      of both cases is syntax error recovery.  That is, a syntax error
+      occurs when the lookahead is syntactically erroneous for the
+      currently established initial context, so error recovery manipulates
+      the parser stacks to try to find a new initial context in which the
+      current lookahead is syntactically acceptable.  If it fails to find
+      such a context, it discards the lookahead.  */
+    if (yy_lac_established_)
+      {
+        YYCDEBUG << "LAC: initial context discarded due to "
+                 << event << '\n';
+        yy_lac_established_ = false;
+      }
+  }
+
+
+  int
+  parser::yy_syntax_error_arguments_ (const context& yyctx,
+                                                 symbol_kind_type yyarg[], int yyargn) const
+  {
+    /* There are many possibilities here to consider:
+       - If this state is a consistent state with a default action, then
+         the only way this function was invoked is if the default action
+         is an error action.  In that case, don't check for expected
+         tokens because there are none.
+       - The only way there can be no lookahead present (in yyla) is
+         if this state is a consistent state with a default action.
+         Thus, detecting the absence of a lookahead is sufficient to
+         determine that there is no unexpected or expected token to
+         report.  In that case, just report a simple "syntax error".
+       - Don't assume there isn't a lookahead just because this state is
+         a consistent state with a default action.  There might have
+         been a previous inconsistent state, consistent state with a
+         non-default action, or user semantic action that manipulated
+         yyla.  (However, yyla is currently not documented for users.)
+         In the first two cases, it might appear that the current syntax
+         error should have been detected in the previous state when
+         yy_lac_check was invoked.  However, at that time, there might
+         have been a different syntax error that discarded a different
+         initial context during error recovery, leaving behind the
+         current lookahead.
+    */
+
+    if (!yyctx.lookahead ().empty ())
+      {
+        if (yyarg)
+          yyarg[0] = yyctx.token ();
+        int yyn = yyctx.expected_tokens (yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+        return yyn + 1;
+      }
+    return 0;
+  }
+
+  // Generate an error message.
+  std::string
+  parser::yysyntax_error_ (const context& yyctx) const
+  {
+    // Its maximum.
+    enum { YYARGS_MAX = 5 };
+    // Arguments of yyformat.
+    symbol_kind_type yyarg[YYARGS_MAX];
+    int yycount = yy_syntax_error_arguments_ (yyctx, yyarg, YYARGS_MAX);
+
+    char const* yyformat = YY_NULLPTR;
+    switch (yycount)
+      {
+#define YYCASE_(N, S)                         \
+        case N:                               \
+          yyformat = S;                       \
+        break
+      default: // Avoid compiler warnings.
+        YYCASE_ (0, YY_("syntax error"));
+        YYCASE_ (1, YY_("syntax error, unexpected %s"));
+        YYCASE_ (2, YY_("syntax error, unexpected %s, expecting %s"));
+        YYCASE_ (3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+        YYCASE_ (4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+        YYCASE_ (5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+      }
+
+    std::string yyres;
+    // Argument number.
+    std::ptrdiff_t yyi = 0;
+    for (char const* yyp = yyformat; *yyp; ++yyp)
+      if (yyp[0] == '%' && yyp[1] == 's' && yyi < yycount)
+        {
+          yyres += symbol_name (yyarg[yyi++]);
+          ++yyp;
+        }
+      else
+        yyres += *yyp;
+    return yyres;
+  }
+
+
+  const signed char parser::yypact_ninf_ = -57;
+
+  const signed char parser::yytable_ninf_ = -3;
+
+  const short
+  parser::yypact_[] =
+  {
+     -57,    15,   515,   -57,   -54,    14,   -30,    19,   -24,    45,
+      64,   132,   -57,   -57,   -57,   -57,   -57,   -57,   107,   -57,
+      42,   131,    67,   106,    81,   117,   -57,   -33,    -7,   118,
+     -57,   125,   -57,   192,   123,   130,   138,   142,   -57,   -57,
+      61,   -57,    96,   110,   112,   176,   177,   182,   183,   184,
+     185,   -57,   -57,   -57,   -57,   -57,   104,   -23,    79,   -57,
+     124,    79,    79,   164,    79,   126,   165,   129,   -57,   -57,
+     -57,   -57,   139,   146,    10,   -57,   173,   587,   -57,   191,
+     211,   207,   180,   171,   181,   186,   193,   194,   -57,   -57,
+     565,    16,   231,   -57,   237,   238,   -57,   235,   240,   -57,
+     241,   -57,   -57,   -23,   -23,   -23,   -23,   -23,   -23,   -23,
+     -19,   -57,   265,   -57,   -23,   -23,   -23,   -23,   -23,   -23,
+     -23,   -23,   -23,   -23,   -23,   -23,   -23,   -23,   -26,   -26,
+     -57,   239,   242,   243,   244,   245,   246,   -57,   -57,   -57,
+     -57,   147,    79,   -57,   190,   -57,   587,   587,   587,   587,
+     587,   587,   587,   -57,   -57,   -57,   -57,   -15,   -57,   -23,
+     111,   111,   -57,   -57,   633,    72,   613,   607,   637,   637,
+      92,    92,    92,    92,   -57,   205,   -57,   -13,   -57,    58,
+     -57,   -57,   -57,   -57,   -57,   -57,   233,   276,   221,   247,
+     319,   -57,   -20,   -57,   -19,   587,   -57,    11,   -26,   275,
+     248,   -57,   -23,    79,   -57,   -57,   214,   256,   -57,   224,
+     -57,   -57,   225,   170,   587,   278,   279,   -57,   271,    78,
+     -57,   -57,   -57,   -57,   362,   -57,   -19,   -57,   405,   448,
+     491,   -57,   151,   -57,   -57,   -57,   277,   -57
+  };
+
+  const signed char
+  parser::yydefact_[] =
+  {
+       3,     0,     0,     1,     0,     0,     0,     0,     0,     0,
+       0,     4,     5,     6,     7,     8,    10,     9,     0,    98,
+       0,     0,     0,     0,     0,     0,    18,     0,     0,     0,
+      11,     0,    33,     0,     0,     0,     0,     0,    12,    33,
+       0,    17,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    19,    14,    13,    16,    15,     0,     0,     0,    31,
+       0,     0,     0,     0,     0,     0,     0,     0,    50,    51,
+      52,    53,     0,     0,    56,    57,     0,    38,    36,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    32,    56,
+       0,    56,     0,    49,     0,     0,    33,     0,     0,    33,
+       0,    54,    55,     0,     0,     0,     0,     0,     0,     0,
+      91,    35,    47,    34,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    85,    85,
+      24,     0,     0,     0,     0,     0,     0,    58,    37,    33,
+      33,     0,     0,    33,     0,    82,    40,    41,    42,    43,
+      44,    45,    46,    94,    95,    97,    96,     0,    92,     0,
+      59,    60,    61,    62,    63,    64,    71,    72,    65,    66,
+      67,    68,    69,    70,    90,     0,    88,     0,    86,     0,
+      25,    26,    27,    28,    29,    30,     0,     0,     0,     0,
+       0,    80,     0,    39,     0,    48,    89,     0,     0,     0,
+      73,    76,     0,     0,    79,    81,     0,     0,    93,     0,
+      20,    87,     0,     0,    77,     0,     0,    33,     0,     0,
+      33,    75,    33,    33,     0,    21,    91,    22,     0,     0,
+       0,    84,     0,    74,    78,    83,     0,    23
+  };
+
+  const short
+  parser::yypgoto_[] =
+  {
+     -57,   -57,   -57,   -57,   -57,   -57,   -57,   -57,   -57,   -57,
+     -57,   -39,   -56,   -53,    93,   -57,   179,   113,    83,   116,
+     -57
+  };
+
+  const unsigned char
+  parser::yydefgoto_[] =
+  {
+       0,     1,     2,    11,    12,    13,    14,    15,    33,    51,
+      16,    40,    76,    77,    78,   192,   177,   178,   157,   158,
+      17
+  };
+
+  const short
+  parser::yytable_[] =
+  {
+      56,    57,    92,   174,    90,    94,    95,   205,    97,    22,
+     193,    18,   197,   103,   209,     3,   194,   175,   198,   103,
+     104,   105,   106,   107,   108,   109,   104,   105,   106,   107,
+     108,   109,    34,    35,   110,    20,   206,   207,   111,   176,
+     110,   210,    89,    75,    23,    27,   153,   154,   155,   156,
+     146,   147,   148,   149,   150,   151,   152,   141,    36,    37,
+     144,   160,   161,   162,   163,   164,   165,   166,   167,   168,
+     169,   170,   171,   172,   173,   112,   114,   115,   116,   117,
+     118,   112,    19,   199,    21,    57,   189,    58,    59,   198,
+     122,   123,   124,   125,   126,   127,   114,   115,   116,   117,
+     186,   187,   226,    57,   190,    58,   195,    60,   227,    61,
+      24,    62,    63,    64,    65,    66,    67,   116,   117,    68,
+      69,    70,    71,    72,    73,    60,    74,    75,    57,    25,
+      58,    88,    -2,    26,    28,    29,    30,    68,    69,    70,
+      71,    72,    73,    32,    91,    75,    31,   215,    38,   214,
+      60,    39,    61,    52,    62,    63,    64,    65,    66,    67,
+      53,    79,    68,    69,    70,    71,    72,    73,    54,    74,
+      75,    57,    55,    58,   188,    80,   236,    81,   224,    82,
+      83,   228,   194,   229,   230,    84,    85,    86,    87,    93,
+      96,    99,    98,    60,   100,    61,   220,    62,    63,    64,
+      65,    66,    67,   113,   101,    68,    69,    70,    71,    72,
+      73,   102,    74,    75,    57,   128,    58,   191,    61,    41,
+      62,    63,    64,    65,    66,    67,    42,    43,    44,    45,
+      46,    47,    48,    49,    50,   129,    60,   130,    61,   132,
+      62,    63,    64,    65,    66,    67,   131,   133,    68,    69,
+      70,    71,    72,    73,   134,    74,    75,    57,   138,    58,
+     200,   135,   136,   139,   140,   142,   143,   145,   159,   180,
+     196,   202,   181,   182,   183,   184,   185,   203,   212,    60,
+     216,    61,   217,    62,    63,    64,    65,    66,    67,   218,
+     219,    68,    69,    70,    71,    72,    73,   213,    74,    75,
+      57,   225,    58,   201,   222,   223,   221,   237,   179,   232,
+     208,   211,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    60,     0,    61,     0,    62,    63,    64,    65,
+      66,    67,     0,     0,    68,    69,    70,    71,    72,    73,
+       0,    74,    75,    57,     0,    58,   204,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    60,     0,    61,     0,    62,
+      63,    64,    65,    66,    67,     0,     0,    68,    69,    70,
+      71,    72,    73,     0,    74,    75,    57,     0,    58,   231,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    60,     0,
+      61,     0,    62,    63,    64,    65,    66,    67,     0,     0,
+      68,    69,    70,    71,    72,    73,     0,    74,    75,    57,
+       0,    58,   233,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    60,     0,    61,     0,    62,    63,    64,    65,    66,
+      67,     0,     0,    68,    69,    70,    71,    72,    73,     0,
+      74,    75,    57,     0,    58,   234,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    60,     0,    61,     0,    62,    63,
+      64,    65,    66,    67,     0,     0,    68,    69,    70,    71,
+      72,    73,     0,    74,    75,    57,     0,    58,   235,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    60,     0,    61,
+       0,    62,    63,    64,    65,    66,    67,     4,     5,    68,
+      69,    70,    71,    72,    73,     0,    74,    75,     0,     6,
+       7,     0,     8,     0,     0,     0,     0,     0,     0,   114,
+     115,   116,   117,   118,   119,     0,     0,     0,     0,     9,
+      10,   120,   121,   122,   123,   124,   125,   126,   127,     0,
+     137,   114,   115,   116,   117,   118,   119,     0,     0,     0,
+       0,     0,     0,   120,   121,   122,   123,   124,   125,   126,
+     127,   114,   115,   116,   117,   118,   119,   114,   115,   116,
+     117,   118,   119,   120,     0,   122,   123,   124,   125,   126,
+     127,   122,   123,   124,   125,   126,   127,   114,   115,   116,
+     117,   114,   115,   116,   117,     0,     0,     0,     0,     0,
+       0,   122,   123,   124,   125,   126,   127,   124,   125,   126,
+     127
+  };
+
+  const short
+  parser::yycheck_[] =
+  {
+      39,    24,    58,    29,    57,    61,    62,    27,    64,    33,
+      25,    65,    25,     3,     3,     0,    31,    43,    31,     3,
+      10,    11,    12,    13,    14,    15,    10,    11,    12,    13,
+      14,    15,    65,    66,    24,    65,    56,    57,    28,    65,
+      24,    30,    65,    66,    68,     3,    65,    66,    67,    68,
+     103,   104,   105,   106,   107,   108,   109,    96,    65,    66,
+      99,   114,   115,   116,   117,   118,   119,   120,   121,   122,
+     123,   124,   125,   126,   127,    65,     4,     5,     6,     7,
+       8,    65,    68,    25,    65,    24,   142,    26,    27,    31,
+      18,    19,    20,    21,    22,    23,     4,     5,     6,     7,
+     139,   140,    24,    24,   143,    26,   159,    46,    30,    48,
+      65,    50,    51,    52,    53,    54,    55,     6,     7,    58,
+      59,    60,    61,    62,    63,    46,    65,    66,    24,    65,
+      26,    27,     0,    26,     3,    68,    30,    58,    59,    60,
+      61,    62,    63,    26,    65,    66,    65,   203,    30,   202,
+      46,    26,    48,    30,    50,    51,    52,    53,    54,    55,
+      30,    65,    58,    59,    60,    61,    62,    63,    30,    65,
+      66,    24,    30,    26,    27,    65,    25,    65,   217,     3,
+       3,   220,    31,   222,   223,     3,     3,     3,     3,    65,
+      26,    26,    66,    46,    65,    48,    26,    50,    51,    52,
+      53,    54,    55,    30,    65,    58,    59,    60,    61,    62,
+      63,    65,    65,    66,    24,    24,    26,    27,    48,    27,
+      50,    51,    52,    53,    54,    55,    34,    35,    36,    37,
+      38,    39,    40,    41,    42,    24,    46,    30,    48,    68,
+      50,    51,    52,    53,    54,    55,    66,    66,    58,    59,
+      60,    61,    62,    63,    68,    65,    66,    24,    27,    26,
+      27,    68,    68,    26,    26,    30,    26,    26,     3,    30,
+      65,    50,    30,    30,    30,    30,    30,    30,     3,    46,
+      66,    48,    26,    50,    51,    52,    53,    54,    55,    65,
+      65,    58,    59,    60,    61,    62,    63,    49,    65,    66,
+      24,    30,    26,    27,    26,    26,   213,    30,   129,   226,
+     194,   198,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    46,    -1,    48,    -1,    50,    51,    52,    53,
+      54,    55,    -1,    -1,    58,    59,    60,    61,    62,    63,
+      -1,    65,    66,    24,    -1,    26,    27,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    46,    -1,    48,    -1,    50,
+      51,    52,    53,    54,    55,    -1,    -1,    58,    59,    60,
+      61,    62,    63,    -1,    65,    66,    24,    -1,    26,    27,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,
+      48,    -1,    50,    51,    52,    53,    54,    55,    -1,    -1,
+      58,    59,    60,    61,    62,    63,    -1,    65,    66,    24,
+      -1,    26,    27,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    46,    -1,    48,    -1,    50,    51,    52,    53,    54,
+      55,    -1,    -1,    58,    59,    60,    61,    62,    63,    -1,
+      65,    66,    24,    -1,    26,    27,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    46,    -1,    48,    -1,    50,    51,
+      52,    53,    54,    55,    -1,    -1,    58,    59,    60,    61,
+      62,    63,    -1,    65,    66,    24,    -1,    26,    27,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    46,    -1,    48,
+      -1,    50,    51,    52,    53,    54,    55,    32,    33,    58,
+      59,    60,    61,    62,    63,    -1,    65,    66,    -1,    44,
+      45,    -1,    47,    -1,    -1,    -1,    -1,    -1,    -1,     4,
+       5,     6,     7,     8,     9,    -1,    -1,    -1,    -1,    64,
+      65,    16,    17,    18,    19,    20,    21,    22,    23,    -1,
+      25,     4,     5,     6,     7,     8,     9,    -1,    -1,    -1,
+      -1,    -1,    -1,    16,    17,    18,    19,    20,    21,    22,
+      23,     4,     5,     6,     7,     8,     9,     4,     5,     6,
+       7,     8,     9,    16,    -1,    18,    19,    20,    21,    22,
+      23,    18,    19,    20,    21,    22,    23,     4,     5,     6,
+       7,     4,     5,     6,     7,    -1,    -1,    -1,    -1,    -1,
+      -1,    18,    19,    20,    21,    22,    23,    20,    21,    22,
+      23
+  };
+
+  const signed char
+  parser::yystos_[] =
+  {
+       0,    70,    71,     0,    32,    33,    44,    45,    47,    64,
+      65,    72,    73,    74,    75,    76,    79,    89,    65,    68,
+      65,    65,    33,    68,    65,    65,    26,     3,     3,    68,
+      30,    65,    26,    77,    65,    66,    65,    66,    30,    26,
+      80,    27,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    78,    30,    30,    30,    30,    80,    24,    26,    27,
+      46,    48,    50,    51,    52,    53,    54,    55,    58,    59,
+      60,    61,    62,    63,    65,    66,    81,    82,    83,    65,
+      65,    65,     3,     3,     3,     3,     3,     3,    27,    65,
+      82,    65,    81,    65,    81,    81,    26,    81,    66,    26,
+      65,    65,    65,     3,    10,    11,    12,    13,    14,    15,
+      24,    28,    65,    30,     4,     5,     6,     7,     8,     9,
+      16,    17,    18,    19,    20,    21,    22,    23,    24,    24,
+      30,    66,    68,    66,    68,    68,    68,    25,    27,    26,
+      26,    80,    30,    26,    80,    26,    82,    82,    82,    82,
+      82,    82,    82,    65,    66,    67,    68,    87,    88,     3,
+      82,    82,    82,    82,    82,    82,    82,    82,    82,    82,
+      82,    82,    82,    82,    29,    43,    65,    85,    86,    85,
+      30,    30,    30,    30,    30,    30,    80,    80,    27,    81,
+      80,    27,    84,    25,    31,    82,    65,    25,    31,    25,
+      27,    27,    50,    30,    27,    27,    56,    57,    88,     3,
+      30,    86,     3,    49,    82,    81,    66,    26,    65,    65,
+      26,    83,    26,    26,    80,    30,    24,    30,    80,    80,
+      80,    27,    87,    27,    27,    27,    25,    30
+  };
+
+  const signed char
+  parser::yyr1_[] =
+  {
+       0,    69,    70,    71,    71,    72,    72,    72,    72,    72,
+      72,    73,    74,    75,    75,    75,    75,    76,    77,    77,
+      78,    78,    78,    78,    78,    78,    78,    78,    78,    78,
+      78,    79,    79,    80,    80,    80,    80,    81,    81,    81,
+      81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
+      81,    81,    81,    81,    81,    81,    82,    82,    82,    82,
+      82,    82,    82,    82,    82,    82,    82,    82,    82,    82,
+      82,    82,    82,    83,    83,    83,    83,    83,    83,    83,
+      83,    83,    84,    84,    84,    85,    85,    85,    86,    86,
+      86,    87,    87,    87,    88,    88,    88,    88,    89
+  };
+
+  const signed char
+  parser::yyr2_[] =
+  {
+       0,     2,     2,     0,     2,     1,     1,     1,     1,     1,
+       1,     3,     4,     5,     5,     5,     5,     5,     0,     2,
+       6,     8,     8,    11,     3,     4,     4,     4,     4,     4,
+       4,     5,     6,     0,     3,     3,     2,     3,     1,     4,
+       3,     3,     3,     3,     3,     3,     3,     2,     4,     2,
+       1,     1,     1,     1,     2,     2,     1,     1,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     5,     9,     7,     5,     6,     9,     5,
+       4,     5,     0,     6,     5,     0,     1,     3,     1,     2,
+       1,     0,     1,     3,     1,     1,     1,     1,     2
+  };
+
+
+
+
+#if YYDEBUG
+  const short
+  parser::yyrline_[] =
+  {
+       0,   173,   173,   174,   174,   176,   177,   178,   179,   180,
+     181,   183,   193,   198,   204,   207,   214,   219,   249,   249,
+     253,   258,   264,   270,   277,   278,   279,   280,   281,   282,
+     283,   286,   290,   296,   297,   302,   307,   314,   315,   316,
+     321,   322,   323,   324,   325,   326,   327,   328,   334,   350,
+     351,   352,   353,   354,   356,   357,   364,   365,   366,   367,
+     368,   369,   370,   371,   372,   373,   374,   375,   376,   377,
+     378,   379,   380,   385,   390,   396,   402,   409,   414,   421,
+     426,   430,   438,   439,   444,   451,   452,   453,   456,   457,
+     458,   461,   462,   463,   465,   466,   467,   468,   470
+  };
+
+  void
+  parser::yy_stack_print_ () const
+  {
+    *yycdebug_ << "Stack now";
+    for (stack_type::const_iterator
+           i = yystack_.begin (),
+           i_end = yystack_.end ();
+         i != i_end; ++i)
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
+  }
+
+  void
+  parser::yy_reduce_print_ (int yyrule) const
+  {
+    int yylno = yyrline_[yyrule];
+    int yynrhs = yyr2_[yyrule];
+    // Print the symbols being reduced, and their result.
+    *yycdebug_ << "Reducing stack by rule " << yyrule - 1
+               << " (line " << yylno << "):\n";
+    // The symbols being reduced.
+    for (int yyi = 0; yyi < yynrhs; yyi++)
+      YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
+                       yystack_[(yynrhs) - (yyi + 1)]);
+  }
+#endif // YYDEBUG
+
+
+} // yy
+#line 2429 "obj/parser.cpp"
+
+#line 472 "src/parser.ypp"
+
+
+void yy::parser::error(const location_type& l, const std::string& m) {
+	std::cerr << l << ": ";
+	err::error("{}\n", m);
+}
@@ -1,9 +1,11 @@
+#include <algorithm>
 #include <fmt/format.h>
 #include <functional>
 #include <unordered_set>
 #include "exception.hpp"
 #include "langs.hpp"
 #include "main.hpp"
+#include "native.hpp"
 #include "types.hpp"
 
 using std::string;
@@ -18,6 +20,10 @@ struct variable {
 
 struct variable_list {
 	std::vector<variable> variables;
+	// The highest offset allocated so far, and the number of internal
+	// variables allocated.
+	unsigned peak = 0;
+	unsigned temporaries = 0;
 
 	string alloc(unsigned size, bool internal, const string& name = "") {
 		if (variables.size() == 0) {
@@ -36,6 +42,8 @@ struct variable_list {
 			// if we make it here, create a variable.
 			variables[i].size = size;
 			variables[i].internal = internal;
+			if (i + size > peak) peak = i + size;
+			if (internal) temporaries++;
 			if (internal) variables[i].name = format("__evstemp{}", i);
 			else variables[i].name = name;
 			return variables[i].name;
@@ -104,17 +112,46 @@ struct variable_list {
 	variable_list(unsigned pool) { variables.resize(pool); }
 };
 
-// A list of constant strings found in the script.
-// These will be placed after the script is compiled.
-typedef std::vector<string> string_table;
 // A list of previously defined labels. This tells the script when to append a .
 // to a label name, as RGBASM's local labels are defined using a .
 typedef std::unordered_set<string> label_table;
 
-void script::compile(FILE * out, const string& name, environment& env) {
+// Formats a location as `file:line`. Terminators have no location.
+static string location_string(const yy::location& l) {
+	if (!l.begin.filename) return "<none>";
+	return format("{}:{}", *l.begin.filename, l.begin.line);
+}
+
+// The number of bytes a string literal occupies once assembled, not including
+// any terminator. Escape sequences are a single byte.
+static unsigned string_size(const string& str) {
+	unsigned size = 0;
+	for (size_t i = 0; i < str.length(); i++, size++) {
+		if (str[i] == '\\') i++;
+	}
+	return size;
+}
+
+unsigned instruction::size() const {
+	unsigned total = type == instype::BYTECODE ? 1 : 0;
+	if (type == instype::LABEL || type == instype::MACRO) return 0;
+	for (auto& i : operands) {
+		total += i.type == optype::STRING ? string_size(i.value) : i.size;
+	}
+	return total;
+}
+
+void script::compile(const string& name, environment& env) {
 	variable_list varlist {env.pool};
-	string_table s_table;
 	label_table l_table;
+	// The location of the statement currently being compiled, and the
+	// statements which contain it.
+	yy::location location;
+	string context;
+
+	code.clear();
+	strings.clear();
+	stats = {};
 
 	std::function<void(statement&)> compile_statement;
 	std::function<void(std::vector<statement>&)> compile_statements;
@@ -135,49 +172,32 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		case argtype::CON:
 			return argument.str;
 		case argtype::STR:
-			s_table.push_back(argument.str);
-			return format(fmt::runtime(lang.local_label), format("string_table{}", s_table.size() - 1));
+			strings.push_back({argument.str, location, context});
+			return format(fmt::runtime(lang.local_label), format("string_table{}", strings.size() - 1));
 		default:
 			err::fatal("Reordered arguments are only allowed in macro definitions");
 		}
 	};
 
-	auto print_value = [&](size_t size, unsigned value) {
-		if (size > 4) err::fatal("Cannot output value of size {}", size);
-		for (int i = 0; i < size; i++) {
-			print(
-				out, "\t{} ({} >> {}) & {}\n",
-				lang.byte, format(fmt::runtime(lang.number), value), i * 8, format(fmt::runtime(lang.number), 0xFF)
-			);
-		}
-	};
-
-	auto print_argument = [&](size_t size, const arg& argument) {
+	auto value_operand = [&](size_t size, const arg& argument) {
 		if (size > 4) err::fatal("Cannot output value of size {}", size);
-		string arg_string = argument_as_string(argument);
-		for (int i = 0; i < size; i++) {
-			print(
-				out, "\t{} ({} >> {}) & {}\n",
-				lang.byte, format(fmt::runtime(lang.number), arg_string), i * 8, format(fmt::runtime(lang.number), 0xFF)
-			);
-		}
+		return operand {optype::VALUE, argument_as_string(argument), (unsigned) size};
 	};
 
 	// Generates a name for an internal label used by the compiler.
 	auto generate_label = [&](const string& l) {
 		string label = format("__{}_{}", l, l_table.size());
 		l_table.emplace(label);
+		stats.labels++;
 		return label;
 	};
 
-	// Prints a label, appending a dot.
-	auto print_label = [&](string label) {
-		print(out, "{}\n", format(fmt::runtime(lang.local_label), label));
+	// Adds a local label, which is printed with a dot.
+	auto push_label = [&](string label) {
+		code.push_back({.type = instype::LABEL, .name = label, .l = location, .context = context});
 	};
 
-	auto print_definition = [&](const string& name, const definition& def, const std::vector<arg>& args) {
-		print(out, "\t; {}\n", name);
-
+	auto push_definition = [&](const string& name, const definition& def, const std::vector<arg>& args) {
 		switch (def.type) {
 		case DEF: {
 			if (def.parameters.size() > args.size()) {
@@ -188,60 +208,54 @@ void script::compile(FILE * out, const string& name, environment& env) {
 					err::warn("{} excess argument{} to {}", dif, "s"[dif == 1], name);
 				}
 			}
-			print_value(1, def.bytecode);
+			instruction ins = {.type = instype::BYTECODE, .name = name, .opcode = name, .l = location, .context = context};
 			for (size_t i = 0; i < def.parameters.size(); i++) {
-				print_argument(def.parameters[i].size, args[i]);
-				print(out, "\n");
+				ins.operands.push_back(value_operand(def.parameters[i].size, args[i]));
 			}
+			code.push_back(ins);
 		} break;
 		case MAC: {
 			definition& source_def = env.defines[def.alias];
-			print_value(1, source_def.bytecode);
+			instruction ins = {.type = instype::BYTECODE, .name = name, .opcode = def.alias, .l = location, .context = context};
 			for (size_t i = 0; i < source_def.parameters.size(); i++) {
 				const arg& macarg = def.arguments[i];
 				switch (macarg.type) {
 				case argtype::STR:
-					print(out, "\t{} \"{}\"", lang.byte, macarg.str);
+					ins.operands.push_back({optype::STRING, macarg.str});
 					break;
 				case argtype::ARG:
-					print_argument(source_def.parameters[i].size, args[macarg.value - 1]);
+					ins.operands.push_back(value_operand(source_def.parameters[i].size, args[macarg.value - 1]));
 					break;
 				default:
-					print_argument(source_def.parameters[i].size, macarg);
+					ins.operands.push_back(value_operand(source_def.parameters[i].size, macarg));
 					break;
 				}
-				print(out, "\n");
 			}
+			code.push_back(ins);
 		} break;
 		case ALIAS: {
-			print(out, "\t{}", format(fmt::runtime(lang.macro_open), def.alias));
+			instruction ins = {.type = instype::MACRO, .name = name, .opcode = def.alias, .l = location, .context = context};
 			size_t i = 0;
-			// I came up with this little hack and I'm very proud of it.
-			// So here's a comment proclaiming such.
-			// I'll leave figuring out how the condition works as a challenge to the reader.
-			if (def.parameters.size()) do {
-				if (def.parameters[i].type == VARARGS) break;
-				print(out, "{}", argument_as_string(args[i++]));
-			} while (i < def.parameters.size() && (print(out, ", "), 1));
-
+			for (; i < def.parameters.size() && def.parameters[i].type != VARARGS; i++) {
+				ins.operands.push_back({optype::VALUE, argument_as_string(args[i])});
+			}
+			ins.variadic = i < def.parameters.size();
 			for (; i < args.size(); i++) {
 				// Special case for string literals
 				if (args[i].type == argtype::STR) {
-					print(out, "\"{}\"", args[i].str);
+					ins.operands.push_back({optype::STRING, args[i].str});
 				} else {
-					print(out, "{}", argument_as_string(args[i]));
+					ins.operands.push_back({optype::VALUE, argument_as_string(args[i])});
 				}
-				print(out, ", ");
 			}
-
-			print(out, "{}\n", lang.macro_end);
+			code.push_back(ins);
 		} break;
 		}
 	};
 
-	// Prints a function defined by the standard set of bytecode, printing
+	// Pushes a function defined by the standard set of bytecode, printing
 	// a unique message if it doesn't exist.
-	auto print_standard = [&](const string& name, const std::vector<arg>& args) {
+	auto push_standard = [&](const string& name, const std::vector<arg>& args) {
 		definition * def = env.get_define(name);
 		if (!def)
 			err::fatal(
@@ -249,15 +263,16 @@ void script::compile(FILE * out, const string& name, environment& env) {
 				"Please `use std;` in your environment or provide an implementation of {0}",
 				name
 			);
-		print_definition(name, *def, args);
+		push_definition(name, *def, args);
 	};
 
-	// Automatically cast a variable and return the new name only if needed.
+	// Automatically cast a variable to the size of `dest`, returning the name
+	// of a new temporary only if needed.
 	auto auto_cast = [&](variable& dest, variable& source) {
-		string cast = dest.name;
+		string cast = source.name;
 		if (dest.size != source.size) {
 			cast = varlist.alloc(dest.size, true);
-			print_standard(
+			push_standard(
 				format("cast_{}to{}", source.size * 8, dest.size * 8),
 				{{argtype::VAR, cast}, {argtype::VAR, source.name}}
 			);
@@ -265,10 +280,25 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		return cast;
 	};
 
+	// The size of the largest variable in an expression, which its
+	// temporaries use if there is no destination.
+	std::function<unsigned(const expression_tree&)> expression_size;
+	expression_size = [&](const expression_tree& tree) -> unsigned {
+		if (tree.is_leaf()) {
+			variable * var = tree.is_number() ? nullptr : varlist.get(tree.identifier);
+			return var ? var->size : 1;
+		}
+		return std::max(expression_size(tree.operands[0]), expression_size(tree.operands[1]));
+	};
+
 	// Convert an operation to be used as a conditional by assigning a unique
 	// destination.
 	auto conditional_operation = [&](statement& stmt) {
-		if (stmt.type >= ASSIGN && stmt.type <= DIV) {
+		if (stmt.type == EXPRESSION) {
+			if (stmt.identifier.length() == 0) {
+				stmt.identifier = varlist.alloc(expression_size(stmt.expression[0]), true);
+			}
+		} else if (stmt.type >= ASSIGN && stmt.type <= DIV) {
 			if (stmt.identifier.length() == 0) {
 				unsigned lhs_size = varlist.required_get(stmt.lhs).size;
 				unsigned rhs_size = 0;
@@ -287,6 +317,74 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		}
 	};
 
+	// Numbers, and names which are not variables, are constants.
+	auto is_constant = [&](const expression_tree& tree) {
+		return tree.is_leaf() && (tree.is_number() || !varlist.get(tree.identifier));
+	};
+
+	auto is_compound = [](const statement& cond) {
+		return cond.type == LOGICAL_AND || cond.type == LOGICAL_OR;
+	};
+
+	// Free any temporary variable generated for a simple condition. Compound
+	// conditions free their temporaries as they go.
+	auto free_condition = [&](statement& cond) {
+		if (!is_compound(cond)) varlist.auto_free(cond.identifier);
+	};
+
+	// Compile a condition, then jump to `label` if it evaluates to `when`,
+	// falling through otherwise. && and || become a chain of branches which
+	// stop as soon as the result is known, so the right-hand side is only
+	// evaluated if needed, and no result is stored.
+	std::function<void(statement&, bool, const string&)> compile_branch;
+	compile_branch = [&](statement& cond, bool when, const string& label) {
+		if (is_compound(cond) && !passes.runs("short-circuit")) {
+			cond = {.type = EXPRESSION, .expression = cond.expression, .l = cond.l};
+		}
+		if (!is_compound(cond)) {
+			// A lone byte can be tested without copying it. Conditional
+			// jumps only read one byte, so wider variables are compared
+			// against 0 instead.
+			bool lone = cond.type == EXPRESSION && cond.identifier.length() == 0
+				&& !is_constant(cond.expression[0])
+				&& cond.expression[0].is_leaf();
+			if (lone && varlist.required_get(cond.expression[0].identifier).size == 1) {
+				cond.identifier = cond.expression[0].identifier;
+			} else {
+				if (lone) {
+					string name = cond.expression[0].identifier;
+					cond = {.type = CONST_NOT, .lhs = name, .value = 0, .l = cond.l};
+				}
+				conditional_operation(cond);
+				compile_statement(cond);
+			}
+			push_standard(when ? "goto_conditional" : "goto_conditional_not", {
+				{argtype::VAR, cond.identifier},
+				{argtype::VAR, label}
+			});
+			return;
+		}
+
+		statement& lhs = cond.conditions[0];
+		statement& rhs = cond.conditions[1];
+		// If the lhs alone can decide the opposite result (`a && b` being
+		// false, or `a || b` being true), skip the rhs. Otherwise, the lhs
+		// can branch straight to the label.
+		if ((cond.type == LOGICAL_AND) == when) {
+			string skip_label = generate_label(cond.type == LOGICAL_AND ? "andfalse" : "ortrue");
+			compile_branch(lhs, !when, skip_label);
+			free_condition(lhs);
+			compile_branch(rhs, when, label);
+			free_condition(rhs);
+			push_label(skip_label);
+		} else {
+			compile_branch(lhs, when, label);
+			free_condition(lhs);
+			compile_branch(rhs, when, label);
+			free_condition(rhs);
+		}
+	};
+
 	auto compile_ASSIGN = [&](statement& stmt) {
 		const char * command_table[] = {
 			"copy_const", "copy16_const", "copy24_const", "copy32_const"
@@ -295,11 +393,13 @@ void script::compile(FILE * out, const string& name, environment& env) {
 			{argtype::VAR, stmt.identifier}, {argtype::NUM, "", stmt.value}
 		};
 		variable& var = varlist.required_get(stmt.identifier);
-		print_standard(command_table[var.size - 1], args);
+		push_standard(command_table[var.size - 1], args);
 	};
 
 	auto compile_DECLARE = [&](statement& stmt) {
 		varlist.alloc(stmt.size, false, stmt.identifier);
+		// An initializer which is more than a number or variable.
+		compile_statements(stmt.statements);
 	};
 
 	auto compile_DECLARE_ASSIGN = [&](statement& stmt) {
@@ -331,7 +431,7 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		} else {
 			err::fatal("Cannot copy between two global vars, as no size is known");
 		}
-		print_standard(command, args);
+		push_standard(command, args);
 	};
 
 	auto compile_DECLARE_COPY = [&](statement& stmt) {
@@ -342,7 +442,7 @@ void script::compile(FILE * out, const string& name, environment& env) {
 	auto compile_CALL = [&](statement& stmt) {
 		definition * def = env.get_define(stmt.identifier);
 		if (!def) err::fatal("Definition of {} not found", stmt.identifier);
-		print_definition(stmt.identifier, *def, stmt.args);
+		push_definition(stmt.identifier, *def, stmt.args);
 	};
 
 	auto compile_DROP = [&](statement& stmt) {
@@ -350,11 +450,11 @@ void script::compile(FILE * out, const string& name, environment& env) {
 	};
 
 	auto compile_LABEL = [&](statement& stmt) {
-		print_label(stmt.identifier);
+		push_label(stmt.identifier);
 	};
 
 	auto compile_GOTO = [&](statement& stmt) {
-		print_standard("goto", {{argtype::VAR, stmt.identifier}});
+		push_standard("goto", {{argtype::VAR, stmt.identifier}});
 	};
 
 	auto compile_IF = [&](statement& stmt) {
@@ -362,12 +462,7 @@ void script::compile(FILE * out, const string& name, environment& env) {
 
 		// Convert and compile the conditional, then insert a jump for
 		// when it is false.
-		conditional_operation(stmt.conditions[0]);
-		compile_statement(stmt.conditions[0]);
-		print_standard("goto_conditional_not", {
-			{argtype::VAR, stmt.conditions[0].identifier},
-			{argtype::VAR, end_label}
-		});
+		compile_branch(stmt.conditions[0], false, end_label);
 
 		// Compile the block of statements to be executed when the
 		// condition is true.
@@ -379,16 +474,16 @@ void script::compile(FILE * out, const string& name, environment& env) {
 			string else_label = generate_label("endelse");
 			// Insert a jump to skip the else block when the
 			// condition is true.
-			print_standard("goto", {{argtype::VAR, else_label}});
-			print_label(end_label);
+			push_standard("goto", {{argtype::VAR, else_label}});
+			push_label(end_label);
 			compile_statements(stmt.else_statements);
-			print_label(else_label);
+			push_label(else_label);
 		} else {
-			print_label(end_label);			
+			push_label(end_label);			
 		}
 
 		// Free any temporary variables generated for the condition.
-		varlist.auto_free(stmt.conditions[0].identifier);
+		free_condition(stmt.conditions[0]);
 	};
 
 	auto compile_WHILE = [&](statement& stmt) {
@@ -398,25 +493,20 @@ void script::compile(FILE * out, const string& name, environment& env) {
 
 		// Rather than jumping to the start each iteration to check the
 		// condition, jump to the bottom and check it there each iterations
-		print_standard("goto", {{argtype::VAR, cond_label}});
-		print_label(begin_label);
+		push_standard("goto", {{argtype::VAR, cond_label}});
+		push_label(begin_label);
 
 		// Compile the main block of statements.
 		compile_statements(stmt.statements);
 
-		print_label(cond_label);
+		push_label(cond_label);
 		// Convert and compile the conditional, then insert a jump for
 		// when it is true.
-		conditional_operation(stmt.conditions[0]);
-		compile_statement(stmt.conditions[0]);
-		print_standard("goto_conditional", {
-			{argtype::VAR, stmt.conditions[0].identifier},
-			{argtype::VAR, begin_label}
-		});
-		print_label(end_label);
+		compile_branch(stmt.conditions[0], true, begin_label);
+		push_label(end_label);
 
 		// Free any temporary variables generated for the condition.
-		varlist.auto_free(stmt.conditions[0].identifier);
+		free_condition(stmt.conditions[0]);
 	};
 
 	auto compile_DO = [&](statement& stmt) {
@@ -424,19 +514,14 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		string end_label = generate_label("enddo");
 		string cond_label = generate_label("docondition");
 
-		print_label(begin_label);
+		push_label(begin_label);
 		compile_statements(stmt.statements);
-		print_label(cond_label);
-		conditional_operation(stmt.conditions[0]);
-		compile_statement(stmt.conditions[0]);
-		print_standard("goto_conditional", {
-			{argtype::VAR, stmt.conditions[0].identifier},
-			{argtype::VAR, begin_label}
-		});
-		print_label(end_label);
+		push_label(cond_label);
+		compile_branch(stmt.conditions[0], true, begin_label);
+		push_label(end_label);
 
 		// Free any temporary variables generated for the condition.
-		varlist.auto_free(stmt.conditions[0].identifier);
+		free_condition(stmt.conditions[0]);
 	};
 
 	auto compile_FOR = [&](statement& stmt) {
@@ -446,27 +531,43 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		// Compile prologue to initialize the for loop.
 		compile_statement(stmt.conditions[0]);
 
-		print_label(begin_label);
-		// Convert and compile the conditional, then insert a jump for
-		// when it is false.
-		conditional_operation(stmt.conditions[1]);
-		compile_statement(stmt.conditions[1]);
-		print_standard("goto_conditional_not", {
-			{argtype::VAR, stmt.conditions[1].identifier},
-			{argtype::VAR, end_label}
-		});
+		if (!passes.runs("rotate-loops")) {
+			push_label(begin_label);
+			// Convert and compile the conditional, then insert a jump for
+			// when it is false.
+			compile_branch(stmt.conditions[1], false, end_label);
 
-		// Compile the main block of statements.
-		compile_statements(stmt.statements);
+			// Compile the main block of statements.
+			compile_statements(stmt.statements);
+
+			// Compile the epilogue, and then jump back to the condition.
+			compile_statement(stmt.conditions[2]);
+			push_standard("goto", {{argtype::VAR, begin_label}});
 
-		// Compile the epilogue, and then jump back to the condition.
+			push_label(end_label);
+			free_condition(stmt.conditions[1]);
+			return;
+		}
+		string cond_label = generate_label("forcondition");
+
+		// Like while, check the condition at the bottom, so that each
+		// iteration only needs one jump.
+		push_standard("goto", {{argtype::VAR, cond_label}});
+		push_label(begin_label);
+
+		// Compile the main block of statements, followed by the epilogue.
+		compile_statements(stmt.statements);
 		compile_statement(stmt.conditions[2]);
-		print_standard("goto", {{argtype::VAR, begin_label}});
 
-		print_label(end_label);
+		push_label(cond_label);
+		// Convert and compile the conditional, then insert a jump for
+		// when it is true.
+		compile_branch(stmt.conditions[1], true, begin_label);
+		push_label(end_label);
+		stats.rotated_loops++;
 
 		// Free any temporary variables generated for the condition.
-		varlist.auto_free(stmt.conditions[1].identifier);
+		free_condition(stmt.conditions[1]);
 	};
 
 	auto compile_REPEAT = [&](statement& stmt) {
@@ -482,27 +583,83 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		else if (stmt.value < 65536) i_size = 2;
 		else err::fatal("Repeat loops are limited to 65536 iterations");
 
-		// compile prologue.
+		// The counter is allocated first so that the body cannot reuse it.
+		// The pool is saved so that an unrolled body can be compiled again
+		// without it.
+		variable_list unrolled_varlist = varlist;
+		size_t strings_start = strings.size();
 		string temp_var = varlist.alloc(i_size, true);
-		print_standard(
-			i_size == 1 ? "copy_const" : format("copy{}_const", i_size * 8),
-			{{argtype::VAR, temp_var}, {argtype::NUM, "", stmt.value}}
-		);
+		string copy = i_size == 1 ? "copy_const" : format("copy{}_const", i_size * 8);
+		string loop = format("loop_dec{}", i_size * 8);
 
-		print_label(begin_label);
+		size_t body_start = code.size();
 		compile_statements(stmt.statements);
+		std::vector<instruction> body(code.begin() + body_start, code.end());
+		code.resize(body_start);
+
+		// Small bodies are unrolled if that is no larger than the loop.
+		// Labels cannot be repeated, and macros have an unknown size.
+		bool unroll = passes.runs("unroll");
+		unsigned body_size = 0;
+		for (auto& ins : body) {
+			if (ins.type == instype::LABEL || ins.type == instype::MACRO) unroll = false;
+			body_size += ins.size();
+		}
+		unsigned loop_size = body_size + 1 + 1 + i_size + 1 + 1 + 2;
+		// Extra bytes are only spent on loops which run, if the profile
+		// measured this one.
+		unsigned threshold = unroll_threshold;
+		if (
+			unroll && body_size * stmt.value > loop_size && body_size * stmt.value <= threshold
+			&& execution_profile.label_count(name, begin_label) == 0
+		) {
+			execution_profile.decisions.push_back(format(
+				"Kept the repeat loop in {} at {} rolled, since it never ran", name, location_string(location)
+			));
+			threshold = 0;
+		}
+		if (unroll && body_size * stmt.value <= std::max(loop_size, threshold)) {
+			// Without labels, the body cannot have generated any, so
+			// only the pool and strings need to be restored.
+			varlist = unrolled_varlist;
+			strings.erase(strings.begin() + strings_start, strings.end());
+			compile_statements(stmt.statements);
+			body.assign(code.begin() + body_start, code.end());
+			for (unsigned i = 1; i < stmt.value; i++) {
+				code.insert(code.end(), body.begin(), body.end());
+			}
+			return;
+		}
 
-		print_label(cond_label);
-		print_standard(
-			i_size == 1 ? "sub_const" : format("sub{}_const", i_size * 8),
-			{{argtype::VAR, temp_var}, {argtype::NUM, "", 1}, {argtype::VAR, temp_var}}
-		);
-		print_standard("goto_conditional", {
-			{argtype::VAR, temp_var},
-			{argtype::VAR, begin_label}
-		});
+		// compile prologue.
+		push_standard(copy, {{argtype::VAR, temp_var}, {argtype::NUM, "", stmt.value}});
+		push_label(begin_label);
+		code.insert(code.end(), body.begin(), body.end());
+		push_label(cond_label);
+
+		// Environments without a loop instruction count down by hand.
+		if (passes.runs("loop-dec") && env.get_define(loop)) {
+			push_standard(loop, {{argtype::VAR, temp_var}, {argtype::VAR, begin_label}});
+		} else {
+			push_standard(
+				i_size == 1 ? "sub_const" : format("sub{}_const", i_size * 8),
+				{{argtype::VAR, temp_var}, {argtype::NUM, "", 1}, {argtype::VAR, temp_var}}
+			);
+			// Conditional jumps only read one byte, so a wider counter is
+			// compared against 0.
+			if (i_size == 1) {
+				push_standard("goto_conditional", {
+					{argtype::VAR, temp_var},
+					{argtype::VAR, begin_label}
+				});
+			} else {
+				statement cond = {.type = CONST_NOT, .lhs = temp_var, .value = 0, .l = location};
+				compile_branch(cond, true, begin_label);
+				free_condition(cond);
+			}
+		}
 
-		print_label(end_label);
+		push_label(end_label);
 
 		// Free the temporary counter variable.
 		varlist.free(temp_var);
@@ -512,10 +669,110 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		string begin_label = generate_label("beginloop");
 		string end_label = generate_label("endloop");
 
-		print_label(begin_label);
+		push_label(begin_label);
 		compile_statements(stmt.statements);
-		print_standard("goto", {{argtype::VAR, begin_label}});
-		print_label(end_label);
+		push_standard("goto", {{argtype::VAR, begin_label}});
+		push_label(end_label);
+	};
+
+	auto compile_SWITCH = [&](statement& stmt) {
+		variable& var = varlist.required_get(stmt.identifier);
+		if (var.size != 1) {
+			err::fatal("switch requires a u8, but {} is {} bytes", stmt.identifier, var.size);
+		}
+
+		string end_label = generate_label("endswitch");
+		string default_label = end_label;
+		statement * default_case = nullptr;
+		// The label of each case's block, by value.
+		std::map<unsigned, string> targets;
+		std::vector<std::pair<statement *, string>> blocks;
+		for (auto& c : stmt.statements) {
+			if (c.type != CASE) {
+				if (default_case) err::fatal("switch on {} has more than one default", stmt.identifier);
+				default_case = &c;
+				default_label = generate_label("default");
+			} else if (c.value > 255) {
+				err::fatal("Case {} does not fit in a u8", c.value);
+			} else if (targets.contains(c.value)) {
+				err::fatal("Duplicate case {} in switch on {}", c.value, stmt.identifier);
+			} else {
+				targets[c.value] = generate_label("case");
+				blocks.push_back({&c, targets[c.value]});
+			}
+		}
+
+		unsigned range = targets.size() ? targets.rbegin()->first - targets.begin()->first + 1 : 0;
+		if (
+			targets.size() >= 3 && range <= 2 * targets.size() && range <= 255
+			&& passes.runs("jump-tables") && env.get_define("jump_table")
+		) {
+			// Dense cases index a table of targets, which costs two bytes
+			// for every value in range, including gaps. The count is a
+			// single byte, so a switch over every value uses the search.
+			unsigned minimum = targets.begin()->first;
+			push_standard("jump_table", {
+				{argtype::VAR, stmt.identifier},
+				{argtype::NUM, "", minimum},
+				{argtype::NUM, "", range}
+			});
+			instruction& ins = code.back();
+			ins.operands.push_back(value_operand(2, {argtype::VAR, default_label}));
+			for (unsigned i = minimum; i < minimum + range; i++) {
+				const string& label = targets.contains(i) ? targets[i] : default_label;
+				ins.operands.push_back(value_operand(2, {argtype::VAR, label}));
+			}
+		} else if (targets.size()) {
+			// Sparse cases are found by a binary search, which shares a
+			// single temporary for each comparison.
+			string temp = varlist.alloc(1, true);
+			std::vector<std::pair<unsigned, string>> sorted(targets.begin(), targets.end());
+			std::function<void(size_t, size_t)> compile_tree = [&](size_t lo, size_t hi) {
+				// Short runs are cheaper to compare one at a time.
+				if (hi - lo <= 3) {
+					for (size_t i = lo; i < hi; i++) {
+						push_standard("equ_const", {
+							{argtype::VAR, stmt.identifier},
+							{argtype::NUM, "", sorted[i].first},
+							{argtype::VAR, temp}
+						});
+						push_standard("goto_conditional", {
+							{argtype::VAR, temp}, {argtype::VAR, sorted[i].second}
+						});
+					}
+					push_standard("goto", {{argtype::VAR, default_label}});
+					return;
+				}
+				size_t mid = (lo + hi) / 2;
+				string lower_label = generate_label("switchlower");
+				push_standard("lt_const", {
+					{argtype::VAR, stmt.identifier},
+					{argtype::NUM, "", sorted[mid].first},
+					{argtype::VAR, temp}
+				});
+				push_standard("goto_conditional", {{argtype::VAR, temp}, {argtype::VAR, lower_label}});
+				compile_tree(mid, hi);
+				push_label(lower_label);
+				compile_tree(lo, mid);
+			};
+			compile_tree(0, sorted.size());
+			varlist.free(temp);
+		}
+
+		// Each block ends by skipping the rest, except the last, which
+		// can fall through to the end.
+		for (size_t i = 0; i < blocks.size(); i++) {
+			push_label(blocks[i].second);
+			compile_statements(blocks[i].first->statements);
+			if (default_case || i + 1 < blocks.size()) {
+				push_standard("goto", {{argtype::VAR, end_label}});
+			}
+		}
+		if (default_case) {
+			push_label(default_label);
+			compile_statements(default_case->statements);
+		}
+		push_label(end_label);
 	};
 
 	auto compile_OPERATION = [&](statement& stmt) {
@@ -523,7 +780,7 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		std::vector<arg> args;
 
 		variable& dest = varlist.required_get(stmt.identifier);
-		string lhs = auto_cast(varlist.required_get(stmt.lhs), dest);
+		string lhs = auto_cast(dest, varlist.required_get(stmt.lhs));
 		bool is_const = stmt.type < EQU;
 		string rhs;
 
@@ -536,7 +793,7 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		} else {
 			variable * rhs_variable = varlist.get(stmt.rhs);
 			if (rhs_variable) {
-				rhs = auto_cast(*rhs_variable, dest);
+				rhs = auto_cast(dest, *rhs_variable);
 				args = {
 					{argtype::VAR, lhs},
 					{argtype::VAR, rhs},
@@ -559,16 +816,164 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		command += command_type[dest.size - 1];
 		if (is_const) command += "_const";
 
-		print_standard(command, args);
+		push_standard(command, args);
+
+		// An expression may reuse one of its operands as the destination.
+		if (lhs != stmt.identifier) varlist.auto_free(lhs);
+		if (!is_const && rhs != stmt.identifier) varlist.auto_free(rhs);
+	};
+
+	// The number of temporaries needed to evaluate an expression, including
+	// its result, if the operand which needs the most is evaluated first
+	// (Sethi-Ullman numbering). Leaves are already in the pool and need none.
+	std::function<unsigned(const expression_tree&)> expression_need;
+	expression_need = [&](const expression_tree& tree) -> unsigned {
+		if (tree.is_leaf()) return 0;
+		unsigned lhs = expression_need(tree.operands[0]);
+		unsigned rhs = expression_need(tree.operands[1]);
+		return lhs == rhs ? lhs + 1 : std::max(lhs, rhs);
+	};
+
+	// Whether an expression reads a variable.
+	std::function<bool(const expression_tree&, const string&)> expression_reads;
+	expression_reads = [&](const expression_tree& tree, const string& name) -> bool {
+		if (tree.is_leaf()) return tree.identifier == name;
+		return expression_reads(tree.operands[0], name) || expression_reads(tree.operands[1], name);
+	};
+
+	auto constant_argument = [](const expression_tree& tree) {
+		if (tree.is_number()) return arg {argtype::NUM, "", tree.value};
+		return arg {argtype::CON, tree.identifier};
+	};
+
+	// Evaluate an expression into a variable and return its name. The result
+	// is written to `target` if one is given, and otherwise to a temporary,
+	// which is reused from the operands where possible. A variable leaf is
+	// simply returned.
+	std::function<string(const expression_tree&, const string&, unsigned)> evaluate;
+	evaluate = [&](const expression_tree& tree, const string& target, unsigned size) -> string {
+		if (tree.is_leaf()) {
+			if (!is_constant(tree)) return tree.identifier;
+			const char * table[] = {
+				"copy_const", "copy16_const", "copy24_const", "copy32_const"
+			};
+			string dest = target.length() ? target : varlist.alloc(size, true);
+			push_standard(table[size - 1], {{argtype::VAR, dest}, constant_argument(tree)});
+			return dest;
+		}
+
+		int type = tree.type;
+		const expression_tree * lhs = &tree.operands[0];
+		const expression_tree * rhs = &tree.operands[1];
+		const char * command_base[] = {"equ", "not", "lt", "lte", "gt", "gte", "add", "sub", "mul", "div", "band", "bor"};
+		const char * command_type[] = {"", "16", "24", "32"};
+		auto has_const_form = [&](int type) {
+			return env.get_define(
+				format("{}{}_const", command_base[type - EQU], command_type[size - 1])
+			) != nullptr;
+		};
+
+		// Move a constant to the right-hand side, where it can be encoded
+		// directly. Comparisons are mirrored, if the environment has the
+		// mirrored form.
+		if (is_constant(*lhs) && !is_constant(*rhs)) {
+			int mirrored = type;
+			switch (type) {
+			case LT: mirrored = GT; break;
+			case LTE: mirrored = GTE; break;
+			case GT: mirrored = LT; break;
+			case GTE: mirrored = LTE; break;
+			case SUB: case DIV: mirrored = NOOP; break;
+			}
+			if (mirrored == type || (mirrored != NOOP && has_const_form(mirrored))) {
+				type = mirrored;
+				std::swap(lhs, rhs);
+			}
+		}
+
+		bool logical = type == LOGICAL_AND || type == LOGICAL_OR;
+		bool is_const = !logical && is_constant(*rhs) && has_const_form(type);
+
+		string lhs_result, rhs_result;
+		if (is_const) {
+			lhs_result = evaluate(*lhs, target, size);
+		} else {
+			// Evaluate the operand which needs more temporaries first, so
+			// that fewer are live at once. Either operand may be built in
+			// the target, as long as nothing evaluated after it reads the
+			// target's old value.
+			bool lhs_first = expression_need(*lhs) >= expression_need(*rhs);
+			const expression_tree& first = lhs_first ? *lhs : *rhs;
+			const expression_tree& second = lhs_first ? *rhs : *lhs;
+			string first_result = evaluate(
+				first, expression_reads(second, target) ? "" : target, size
+			);
+			string second_result = evaluate(
+				second, first_result == target ? "" : target, size
+			);
+			lhs_result = lhs_first ? first_result : second_result;
+			rhs_result = lhs_first ? second_result : first_result;
+		}
+
+		string dest = target;
+		if (dest.empty()) {
+			variable * lhs_variable = varlist.get(lhs_result);
+			variable * rhs_variable = rhs_result.length() ? varlist.get(rhs_result) : nullptr;
+			if (lhs_variable->internal && lhs_variable->size == size) {
+				dest = lhs_result;
+			} else if (rhs_variable && rhs_variable->internal && rhs_variable->size == size) {
+				dest = rhs_result;
+			} else {
+				dest = varlist.alloc(size, true);
+			}
+		}
+
+		if (logical) {
+			push_standard(format("{}{}", type == LOGICAL_AND ? "land" : "lor", command_type[size - 1]), {
+				{argtype::VAR, lhs_result}, {argtype::VAR, rhs_result}, {argtype::VAR, dest}
+			});
+			if (lhs_result != dest) varlist.auto_free(lhs_result);
+			if (rhs_result != dest) varlist.auto_free(rhs_result);
+			return dest;
+		}
+
+		statement operation = {.type = type, .identifier = dest, .lhs = lhs_result, .rhs = rhs_result, .l = location};
+		if (is_const) {
+			operation.type = type - (EQU - CONST_EQU);
+			operation.value = rhs->value;
+			// Named constants are passed through as the rhs.
+			if (!rhs->is_number()) {
+				operation.type = type;
+				operation.rhs = rhs->identifier;
+			}
+		}
+		compile_OPERATION(operation);
+		return dest;
+	};
 
-		varlist.auto_free(lhs);
-		if (!is_const) varlist.auto_free(rhs);
+	auto compile_EXPRESSION = [&](statement& stmt) {
+		if (stmt.identifier.length() == 0) return;
+		unsigned size = varlist.required_get(stmt.identifier).size;
+		string result = evaluate(stmt.expression[0], stmt.identifier, size);
+		if (result != stmt.identifier) {
+			statement copy = {.type = COPY, .identifier = stmt.identifier, .lhs = stmt.identifier, .rhs = result, .l = location};
+			compile_COPY(copy);
+		}
 	};
 
 	compile_statement = [&](statement& stmt) {
+		// Conditions are not given a location by the parser, so they
+		// inherit the location of their control structure.
+		yy::location parent_location = location;
+		string parent_context = context;
+		if (stmt.l.begin.filename) {
+			location = stmt.l;
+			if (context.length()) context += ";";
+			context += format("{}:{}", *location.begin.filename, location.begin.line);
+		}
 		if (debug_file) {
 			string debug_label = generate_label("debug");
-			print_label(debug_label);
+			push_label(debug_label);
 			// The debug format is:
 			// {label}:{line}:[{var name}, {offset}, {size}, {sign}]
 			print(debug_file, "{}.{}:{}:", name, debug_label, stmt.l.begin.line);
@@ -597,15 +1002,19 @@ void script::compile(FILE * out, const string& name, environment& env) {
 			COMPILE(DECLARE_COPY);
 			COMPILE(DO);
 			COMPILE(DROP);
+			COMPILE(EXPRESSION);
 			COMPILE(FOR);
 			COMPILE(GOTO);
 			COMPILE(LABEL);
 			COMPILE(LOOP);
 			COMPILE(IF);
 			COMPILE(REPEAT);
+			COMPILE(SWITCH);
 			COMPILE(WHILE);
 		}
 		#undef COMPILE
+		location = parent_location;
+		context = parent_context;
 	};
 
 	compile_statements = [&](std::vector<statement>& list) {
@@ -617,20 +1026,147 @@ void script::compile(FILE * out, const string& name, environment& env) {
 		}
 	};
 
+	// Compile the contents of the script.
+	compile_statements(statements);
+	// Add a terminator if the user has specified one. This is usually the
+	// bytecode of `return`, so note which definition it refers to in case the
+	// bytecode is renumbered.
+	if (env.terminator >= 0) {
+		string opcode;
+		for (auto& [name, def] : env.defines) {
+			if (def.type != DEF || def.bytecode != unsigned(env.terminator)) continue;
+			// std16 numbers its bytecode from 0 as well, so prefer return.
+			if (opcode.empty() || name == "return" || (opcode != "return" && name < opcode)) {
+				opcode = name;
+			}
+		}
+		code.push_back({
+			.type = instype::DATA,
+			.opcode = opcode,
+			.operands = {{optype::VALUE, format("{}", env.terminator), 1}},
+			.l = location,
+			.context = context,
+		});
+	}
+
+	stats.peak_pool = varlist.peak;
+	stats.temporaries = varlist.temporaries;
+	measure();
+}
+
+void script::measure() {
+	stats.bytecode_bytes = 0;
+	stats.string_bytes = 0;
+	stats.opcodes.clear();
+	stats.lines.clear();
+	stats.macros = 0;
+
+	for (auto& ins : code) {
+		unsigned size = ins.size();
+		stats.bytecode_bytes += size;
+		if (size) stats.lines[location_string(ins.l)] += size;
+		if (ins.type == instype::BYTECODE) stats.opcodes[ins.opcode]++;
+		if (ins.type == instype::MACRO) stats.macros++;
+	}
+	// Native scripts are entered using exec_native.
+	if (native) stats.opcodes["exec_native"]++;
+	// Each of a script's strings is followed by a terminator.
+	for (auto& str : strings) {
+		unsigned size = string_size(str.text) + 1;
+		stats.string_bytes += size;
+		stats.lines[location_string(str.l)] += size;
+	}
+}
+
+void script::profile(std::map<string, unsigned>& stacks, const string& name) {
+	// Each stack begins with the script's name, followed by every
+	// statement which contains the instruction. The final frame is the
+	// definition which produced the bytes, noting any `mac` expansion.
+	auto stack = [&](const string& context, const string& leaf) {
+		string result = name;
+		if (context.length()) result += ";" + context;
+		return result + ";" + leaf;
+	};
+
+	for (auto& ins : code) {
+		unsigned size = ins.size();
+		if (!size) continue;
+		string leaf;
+		if (ins.type == instype::DATA) leaf = "terminator";
+		else if (ins.name != ins.opcode) leaf = format("{}->{}", ins.name, ins.opcode);
+		else leaf = ins.name;
+		stacks[stack(ins.context, leaf)] += size;
+	}
+	for (auto& str : strings) {
+		stacks[stack(str.context, "string")] += string_size(str.text) + 1;
+	}
+}
+
+void instruction::emit(FILE * out, environment& env) const {
+	auto print_value = [&](size_t size, const string& value) {
+		for (int i = 0; i < size; i++) {
+			print(
+				out, "\t{} ({} >> {}) & {}\n",
+				lang.byte, format(fmt::runtime(lang.number), value), i * 8, format(fmt::runtime(lang.number), 0xFF)
+			);
+		}
+	};
+
+	auto print_operand = [&](const operand& op) {
+		if (op.type == optype::STRING) {
+			print(out, "\t{} \"{}\"", lang.byte, op.value);
+		} else {
+			print_value(op.size, op.value);
+		}
+		print(out, "\n");
+	};
+
+	switch (type) {
+	case instype::BYTECODE:
+		print(out, "\t; {}\n", name);
+		print_value(1, format("{}", env.defines[opcode].bytecode));
+		for (auto& op : operands) print_operand(op);
+		break;
+	case instype::DATA:
+		for (auto& op : operands) print_value(op.size, op.value);
+		break;
+	case instype::LABEL:
+		print(out, "{}\n", format(fmt::runtime(lang.local_label), name));
+		break;
+	case instype::MACRO:
+		print(out, "\t; {}\n", name);
+		print(out, "\t{}", format(fmt::runtime(lang.macro_open), opcode));
+		for (size_t i = 0; i < operands.size(); i++) {
+			const operand& op = operands[i];
+			if (op.type == optype::STRING) print(out, "\"{}\"", op.value);
+			else print(out, "{}", op.value);
+			if (variadic || i + 1 < operands.size()) print(out, ", ");
+		}
+		print(out, "{}\n", lang.macro_end);
+		break;
+	}
+}
+
+void script::emit(FILE * out, const string& name, environment& env) {
 	// Special values to disable section creation.
-	if (env.section != "" && env.section != "none") {
-		print(out, "\n{}\n", format(fmt::runtime(lang.section), name, env.section));
+	string section_type = section.length() ? section : env.section;
+	if (section_type != "" && section_type != "none") {
+		if (bank >= 0) section_type = format(fmt::runtime(lang.bank_section), section_type, bank);
+		print(out, "\n{}\n", format(fmt::runtime(lang.section), name, section_type));
 	}
-	// Compile the contents of the script.
 	print(out, "{}\n", format(fmt::runtime(lang.label), name));
-	compile_statements(statements);
-	// Print a terminator if the user has specified one.
-	if (env.terminator >= 0) print_value(1, env.terminator);
+
+	if (native) {
+		emit_native(out, *this, env);
+	} else {
+		for (auto& ins : code) ins.emit(out, env);
+	}
+
 	// Define constant strings
-	for (size_t i = 0; i < s_table.size(); i++) {
+	for (size_t i = 0; i < strings.size(); i++) {
 		print(out, fmt::runtime(lang.local_label), format("string_table{}", i));
 		print(out, "\n");
-		print(out, fmt::runtime(lang.str), s_table[i]);
+		print(out, fmt::runtime(lang.str), strings[i].text);
 		print(out, "\n");
 	}
 }
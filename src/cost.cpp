@@ -0,0 +1,135 @@
+#include <unordered_map>
+#include "cost.hpp"
+
+using std::string;
+
+namespace cost {
+
+struct handler_cost {
+	// Cycles taken by the handler when called by ExecuteScript.
+	unsigned cycles;
+	// Threaded handlers need to preserve the pool pointer themselves.
+	int threaded;
+	// Cycles saved by indexing page pools without a carry.
+	unsigned page_pool;
+};
+
+// Counted from src/runtime, following the path most instructions take.
+// The final ret (or jp EVScriptNext) is part of the dispatch cost.
+static const std::unordered_map<string, handler_cost> handlers = {
+	// Return and yield leave the driver rather than continuing to the next
+	// instruction, but are still counted as a full dispatch.
+	{"StdReturn",                {9, -6, 0}},
+	{"StdYield",                 {6, -6, 0}},
+	{"StdGoto",                  {5, 0, 0}},
+	{"StdGotoFar",               {14, 0, 0}},
+	{"StdGotoConditional",       {20, 0, 2}},
+	{"StdGotoConditionalNot",    {20, 0, 2}},
+	{"StdGotoConditionalFar",    {29, 0, 2}},
+	{"StdGotoConditionalNotFar", {29, 0, 2}},
+	{"StdCallAsm",               {19, 7, 0}},
+	{"StdCallAsmFar",            {28, 7, 0}},
+	{"StdAdd",                   {51, 7, 8}},
+	{"StdSub",                   {51, 7, 8}},
+	{"StdMul",                   {56, 7, 8}},
+	{"StdDiv",                   {55, 7, 8}},
+	{"StdBinaryAnd",             {51, 7, 8}},
+	{"StdBinaryOr",              {51, 7, 8}},
+	{"StdEqu",                   {56, 7, 8}},
+	{"StdNot",                   {56, 7, 8}},
+	{"StdLessThan",              {56, 7, 8}},
+	{"StdGreaterThanEqu",        {56, 7, 8}},
+	{"StdLogicalAnd",            {58, 7, 8}},
+	{"StdLogicalOr",             {58, 7, 8}},
+	{"StdAddConst",              {38, 7, 5}},
+	{"StdSubConst",              {38, 7, 5}},
+	{"StdMulConst",              {43, 7, 5}},
+	{"StdDivConst",              {42, 7, 5}},
+	{"StdBinaryAndConst",        {38, 7, 5}},
+	{"StdBinaryOrConst",         {38, 7, 5}},
+	{"StdEquConst",              {43, 7, 5}},
+	{"StdNotConst",              {43, 7, 5}},
+	{"StdLessThanConst",         {43, 7, 5}},
+	{"StdGreaterThanEquConst",   {43, 7, 5}},
+	{"StdCopy",                  {25, 0, 5}},
+	{"StdLoad",                  {30, 0, 4}},
+	{"StdStore",                 {34, 0, 5}},
+	{"StdCopyConst",             {11, 0, 2}},
+	{"StdLoadConst",             {25, 0, 2}},
+	{"StdStoreConst",            {17, 7, 3}},
+	{"StdLoopDec8",              {20, 0, 2}},
+	{"StdJumpTable",             {39, 0, 2}},
+	{"StdCallSub",               {33, 0, 2}},
+	{"StdReturnSub",             {17, 0, 2}},
+	{"StdAdd16",                 {77, 7, 8}},
+	{"StdSub16",                 {85, 7, 8}},
+	{"StdMul16",                 {79, 7, 8}},
+	{"StdDiv16",                 {79, 7, 8}},
+	{"StdEqu16",                 {83, 7, 8}},
+	{"StdNot16",                 {83, 7, 8}},
+	{"StdLogicalAnd16",          {83, 7, 8}},
+	{"StdLogicalOr16",           {83, 7, 8}},
+	{"StdAddConst16",            {69, 7, 6}},
+	{"StdSubConst16",            {77, 7, 6}},
+	{"StdMulConst16",            {71, 7, 6}},
+	{"StdDivConst16",            {71, 7, 6}},
+	{"StdEquConst16",            {76, 7, 6}},
+	{"StdNotConst16",            {76, 7, 6}},
+	{"StdCopy16",                {26, 7, 5}},
+	{"StdLoad16",                {36, 0, 4}},
+	{"StdStore16",               {35, 7, 5}},
+	{"StdCopyConst16",           {17, 0, 2}},
+	{"StdLoadConst16",           {31, 0, 2}},
+	{"StdStoreConst16",          {41, 7, 3}},
+	{"StdLoopDec16",             {27, 0, 2}},
+	{"StdCopyQ",                 {24, 7, 5}},
+	{"StdCopyConstQ",            {17, 0, 2}},
+	{"StdCopyConst16Q",          {22, 0, 2}},
+	{"StdAddConstQ",             {21, 7, 2}},
+	{"StdSubConstQ",             {21, 7, 2}},
+	{"StdGotoRel8",               {8, 0, 0}},
+	{"StdGotoConditionalRel8",    {23, 0, 2}},
+	{"StdGotoConditionalNotRel8", {23, 0, 2}},
+	{"StdExecNative",             {6, 0, 0}},
+};
+
+unsigned dispatch(const runtime_options& runtime) {
+	// Fetching the opcode and saving and restoring the script pointer takes 9
+	// cycles, plus the table lookup in evs_lookup.
+	unsigned cycles = 9 + (runtime.layout == table_layout::SPLIT ? 8 : 14);
+	switch (runtime.dispatch) {
+	// Call the handler through .callBC (18), then return, restore de, and
+	// loop (10).
+	case dispatch_type::CALL: return cycles + 28;
+	// Jump to the handler (8), then jump back to EVScriptNext (4).
+	case dispatch_type::THREADED: return cycles + 12;
+	}
+	return 0;
+}
+
+static unsigned handler(const string& label, const runtime_options& runtime) {
+	auto entry = handlers.find(label);
+	if (entry == handlers.end()) return 0;
+	unsigned cycles = entry->second.cycles;
+	if (runtime.dispatch == dispatch_type::THREADED) cycles += entry->second.threaded;
+	if (runtime.pool == pool_mode::PAGE) cycles -= entry->second.page_pool;
+	return cycles;
+}
+
+unsigned handler(const definition& def, const runtime_options& runtime) {
+	if (def.fused.empty()) return handler(def.handler, runtime);
+	// Each handler but the last is called, saving the pool pointer (13),
+	// and the last is jumped to (4).
+	unsigned cycles = 4 + 13 * (def.fused.size() - 1);
+	for (auto& label : def.fused) cycles += handler(label, runtime);
+	return cycles;
+}
+
+opcode_cost estimate(const definition& def, runtime_options runtime) {
+	runtime.dispatch = dispatch_type::CALL;
+	unsigned call = dispatch(runtime) + handler(def, runtime);
+	runtime.dispatch = dispatch_type::THREADED;
+	return {call, dispatch(runtime) + handler(def, runtime)};
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "types.hpp"
+
+// A static model of the runtime's cost on the Game Boy, in M-cycles. This is
+// used to compare runtime configurations without needing to run them.
+namespace cost {
+
+// Cycles spent by one executed instruction in each dispatch mode, including
+// its handler.
+struct opcode_cost {
+	unsigned call;
+	unsigned threaded;
+
+	unsigned saved() const { return call - threaded; }
+};
+
+// Cycles spent fetching and dispatching one instruction, excluding its handler.
+unsigned dispatch(const runtime_options& runtime);
+// Cycles spent in the handler of a definition, or 0 if its handler is unknown.
+// Loops within handlers, such as mul and div, are counted once.
+unsigned handler(const definition& def, const runtime_options& runtime);
+// Estimate both dispatch modes, using the table layout and pool mode given.
+opcode_cost estimate(const definition& def, runtime_options runtime);
+
+}
@@ -1,97 +1,174 @@
+#include <set>
 #include "driver.hpp"
+#include "report.hpp"
 
 void driver::load_std(environment& env) {
 	unsigned i = 0;
-	const struct {const char * name; definition def;} stddefs[] = {
+	const struct {const char * name; definition def; const char * handler;} stddefs[] = {
 		// The purpose of each argument is provided in a comment before the
 		// bytecode
-		{ "return", {DEF, i++, {}}},
-		{ "yield", {DEF, i++, {}}},
+		{ "return", {DEF, i++, {}}, "StdReturn"},
+		{ "yield", {DEF, i++, {}}, "StdYield"},
 		// dest
-		{ "goto", {DEF, i++, {{CON, 2}}}},
-		{ "goto_far", {DEF, i++, {{CON, 3}}}},
+		{ "goto", {DEF, i++, {{CON, 2}}}, "StdGoto"},
+		{ "goto_far", {DEF, i++, {{CON, 3}}}, "StdGotoFar"},
 		// test, dest
-		{ "goto_conditional", {DEF, i++, {{ARG, 1}, {CON, 2}}}},
-		{ "goto_conditional_not", {DEF, i++, {{ARG, 1}, {CON, 2}}}},
-		{ "goto_conditional_far", {DEF, i++, {{ARG, 1}, {CON, 3}}}},
-		{ "goto_conditional_not_far", {DEF, i++, {{ARG, 1}, {CON, 3}}}},
+		{ "goto_conditional", {DEF, i++, {{ARG, 1}, {CON, 2}}}, "StdGotoConditional"},
+		{ "goto_conditional_not", {DEF, i++, {{ARG, 1}, {CON, 2}}}, "StdGotoConditionalNot"},
+		{ "goto_conditional_far", {DEF, i++, {{ARG, 1}, {CON, 3}}}, "StdGotoConditionalFar"},
+		{ "goto_conditional_not_far", {DEF, i++, {{ARG, 1}, {CON, 3}}}, "StdGotoConditionalNotFar"},
 		// dest
-		{ "callasm", {DEF, i++, {{CON, 2}}}},
-		{ "callasm_far", {DEF, i++, {{CON, 3}}}},
+		{ "callasm", {DEF, i++, {{CON, 2}}}, "StdCallAsm"},
+		{ "callasm_far", {DEF, i++, {{CON, 3}}}, "StdCallAsmFar"},
 		// lhs, rhs, dest
-		{ "add",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "sub",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "mul",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "div",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "band",        {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "bor",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "equ",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "not",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "lt",          {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "gte",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "land",        {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "lor",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "add_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "sub_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "mul_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "div_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "band_const",  {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "bor_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "equ_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "not_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}},
-		{ "lt_const",    {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
-		{ "gte_const",   {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}},
+		{ "add",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdAdd"},
+		{ "sub",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdSub"},
+		{ "mul",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdMul"},
+		{ "div",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdDiv"},
+		{ "band",        {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdBinaryAnd"},
+		{ "bor",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdBinaryOr"},
+		{ "equ",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdEqu"},
+		{ "not",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdNot"},
+		{ "lt",          {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdLessThan"},
+		{ "gte",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdGreaterThanEqu"},
+		{ "land",        {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdLogicalAnd"},
+		{ "lor",         {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdLogicalOr"},
+		{ "add_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdAddConst"},
+		{ "sub_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdSubConst"},
+		{ "mul_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdMulConst"},
+		{ "div_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdDivConst"},
+		{ "band_const",  {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdBinaryAndConst"},
+		{ "bor_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdBinaryOrConst"},
+		{ "equ_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdEquConst"},
+		{ "not_const",   {DEF, i++, {{ARG, 1}, {CON, 1}, {ARG, 1}}}, "StdNotConst"},
+		{ "lt_const",    {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdLessThanConst"},
+		{ "gte_const",   {DEF, i++, {{ARG, 1}, {ARG, 1}, {ARG, 1}}}, "StdGreaterThanEquConst"},
 		// dest, source
-		{ "copy",        {DEF, i++, {{ARG, 1}, {ARG, 1}}}},
-		{ "load",        {DEF, i++, {{ARG, 1}, {ARG, 2}}}},
-		{ "store",       {DEF, i++, {{ARG, 2}, {ARG, 1}}}},
-		{ "copy_const",  {DEF, i++, {{ARG, 1}, {CON, 1}}}},
-		{ "load_const",  {DEF, i++, {{ARG, 1}, {CON, 2}}}},
-		{ "store_const", {DEF, i++, {{CON, 2}, {ARG, 1}}}},
+		{ "copy",        {DEF, i++, {{ARG, 1}, {ARG, 1}}}, "StdCopy"},
+		{ "load",        {DEF, i++, {{ARG, 1}, {ARG, 2}}}, "StdLoad"},
+		{ "store",       {DEF, i++, {{ARG, 2}, {ARG, 1}}}, "StdStore"},
+		{ "copy_const",  {DEF, i++, {{ARG, 1}, {CON, 1}}}, "StdCopyConst"},
+		{ "load_const",  {DEF, i++, {{ARG, 1}, {CON, 2}}}, "StdLoadConst"},
+		{ "store_const", {DEF, i++, {{CON, 2}, {ARG, 1}}}, "StdStoreConst"},
+		// counter, dest
+		{ "loop_dec8",   {DEF, i++, {{ARG, 1}, {CON, 2}}}, "StdLoopDec8"},
+		// index, minimum, count, followed by a default and count targets
+		{ "jump_table",  {DEF, i++, {{ARG, 1}, {CON, 1}, {CON, 1}}}, "StdJumpTable"},
+		// dest, return address slot
+		{ "call_sub",    {DEF, i++, {{CON, 2}, {CON, 1}}}, "StdCallSub"},
+		// return address slot
+		{ "return_sub",  {DEF, i++, {{CON, 1}}}, "StdReturnSub"},
 	};
 
 	for (size_t i = 0; i < sizeof(stddefs) / sizeof(*stddefs); i++) {
 		env.defines[stddefs[i].name] = stddefs[i].def;
+		env.defines[stddefs[i].name].handler = stddefs[i].handler;
 		env.bytecode_count++;
 	}
 }
 
 void driver::load_std16(environment& env) {
 	unsigned i = 0;
-	const struct {const char * name; definition def;} stddefs[] = {
+	const struct {const char * name; definition def; const char * handler;} stddefs[] = {
 		// lhs, rhs, dest
-		{ "add16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "sub16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "mul16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "div16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "equ16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "not16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "land16",        {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "lor16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}},
-		{ "add16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}},
-		{ "sub16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}},
-		{ "mul16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}},
-		{ "div16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}},
-		{ "equ16_const",   {DEF, i++, {{ARG, 2}, {CON, 2}, {ARG, 2}}}},
-		{ "not16_const",   {DEF, i++, {{ARG, 2}, {CON, 2}, {ARG, 2}}}},
+		{ "add16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdAdd16"},
+		{ "sub16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdSub16"},
+		{ "mul16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdMul16"},
+		{ "div16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdDiv16"},
+		{ "equ16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdEqu16"},
+		{ "not16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdNot16"},
+		{ "land16",        {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdLogicalAnd16"},
+		{ "lor16",         {DEF, i++, {{ARG, 2}, {ARG, 2}, {ARG, 2}}}, "StdLogicalOr16"},
+		{ "add16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}, "StdAddConst16"},
+		{ "sub16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}, "StdSubConst16"},
+		{ "mul16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}, "StdMulConst16"},
+		{ "div16_const",   {DEF, i++, {{ARG, 2}, {ARG, 2}, {CON, 2}}}, "StdDivConst16"},
+		{ "equ16_const",   {DEF, i++, {{ARG, 2}, {CON, 2}, {ARG, 2}}}, "StdEquConst16"},
+		{ "not16_const",   {DEF, i++, {{ARG, 2}, {CON, 2}, {ARG, 2}}}, "StdNotConst16"},
 		// dest, source
-		{ "copy16",        {DEF, i++, {{ARG, 2}, {ARG, 2}}}},
-		{ "load16",        {DEF, i++, {{ARG, 2}, {ARG, 2}}}},
-		{ "store16",       {DEF, i++, {{ARG, 2}, {ARG, 2}}}},
-		{ "copy16_const",  {DEF, i++, {{ARG, 2}, {CON, 2}}}},
-		{ "load16_const",  {DEF, i++, {{ARG, 2}, {CON, 2}}}},
-		{ "store16_const", {DEF, i++, {{CON, 2}, {ARG, 2}}}},
+		{ "copy16",        {DEF, i++, {{ARG, 2}, {ARG, 2}}}, "StdCopy16"},
+		{ "load16",        {DEF, i++, {{ARG, 2}, {ARG, 2}}}, "StdLoad16"},
+		{ "store16",       {DEF, i++, {{ARG, 2}, {ARG, 2}}}, "StdStore16"},
+		{ "copy16_const",  {DEF, i++, {{ARG, 2}, {CON, 2}}}, "StdCopyConst16"},
+		{ "load16_const",  {DEF, i++, {{ARG, 2}, {CON, 2}}}, "StdLoadConst16"},
+		{ "store16_const", {DEF, i++, {{CON, 2}, {ARG, 2}}}, "StdStoreConst16"},
+		// counter, dest
+		{ "loop_dec16",    {DEF, i++, {{ARG, 2}, {CON, 2}}}, "StdLoopDec16"},
 	};
 
 	for (size_t i = 0; i < sizeof(stddefs) / sizeof(*stddefs); i++) {
 		env.defines[stddefs[i].name] = stddefs[i].def;
+		env.defines[stddefs[i].name].handler = stddefs[i].handler;
+		env.bytecode_count++;
+	}
+}
+
+void driver::load_std_compact(environment& env) {
+	unsigned i = 0;
+	// Each operand packs a pool index into its high nibble, and either a
+	// second index or a constant into its low nibble. The compiler uses these
+	// in place of std's definitions when the operands fit.
+	const struct {const char * name; definition def; const char * handler;} stddefs[] = {
+		// dest, source
+		{ "copy_q",         {DEF, i++, {{CON, 1}}}, "StdCopyQ"},
+		// dest, value
+		{ "copy_const_q",   {DEF, i++, {{CON, 1}}}, "StdCopyConstQ"},
+		{ "copy16_const_q", {DEF, i++, {{CON, 1}}}, "StdCopyConst16Q"},
+		// lhs and dest, value
+		{ "add_const_q",    {DEF, i++, {{CON, 1}}}, "StdAddConstQ"},
+		{ "sub_const_q",    {DEF, i++, {{CON, 1}}}, "StdSubConstQ"},
+	};
+
+	for (size_t i = 0; i < sizeof(stddefs) / sizeof(*stddefs); i++) {
+		env.defines[stddefs[i].name] = stddefs[i].def;
+		env.defines[stddefs[i].name].handler = stddefs[i].handler;
+		env.bytecode_count++;
+	}
+}
+
+void driver::load_std_short(environment& env) {
+	unsigned i = 0;
+	// The destination is a signed displacement from the next instruction.
+	// The compiler uses these in place of std's jumps when the target is
+	// close enough.
+	const struct {const char * name; definition def; const char * handler;} stddefs[] = {
+		// dest
+		{ "goto_rel8",                 {DEF, i++, {{CON, 1}}}, "StdGotoRel8"},
+		// test, dest
+		{ "goto_conditional_rel8",     {DEF, i++, {{ARG, 1}, {CON, 1}}}, "StdGotoConditionalRel8"},
+		{ "goto_conditional_not_rel8", {DEF, i++, {{ARG, 1}, {CON, 1}}}, "StdGotoConditionalNotRel8"},
+	};
+
+	for (size_t i = 0; i < sizeof(stddefs) / sizeof(*stddefs); i++) {
+		env.defines[stddefs[i].name] = stddefs[i].def;
+		env.defines[stddefs[i].name].handler = stddefs[i].handler;
+		env.bytecode_count++;
+	}
+}
+
+void driver::load_std_native(environment& env) {
+	unsigned i = 0;
+	// Native scripts are entered, and re-entered after yielding or running
+	// bytecode, by jumping to their SM83 code.
+	const struct {const char * name; definition def; const char * handler;} stddefs[] = {
+		// dest
+		{ "exec_native", {DEF, i++, {{CON, 2}}}, "StdExecNative"},
+	};
+
+	for (size_t i = 0; i < sizeof(stddefs) / sizeof(*stddefs); i++) {
+		env.defines[stddefs[i].name] = stddefs[i].def;
+		env.defines[stddefs[i].name].handler = stddefs[i].handler;
 		env.bytecode_count++;
 	}
 }
 
 int driver::parse(const std::string & f) {
+	// Locations outlive the driver which parsed them when a file is
+	// included, so keep file names in a set which is never freed.
+	static std::set<std::string> filenames;
+	report::phase phase("parse", f);
 	file = f;
-	location.initialize(&file);
+	location.initialize(&*filenames.insert(f).first);
 	scan_begin();
 	yy::parser parser = {*this};
 	parser.set_debug_level(trace_parsing);
@@ -101,6 +178,7 @@ int driver::parse(const std::string & f) {
 }
 
 void driver::merge(driver& source) {
+	report::phase phase("merge");
 	typedefs.insert(source.typedefs.begin(), source.typedefs.end());
 	environments.insert(source.environments.begin(), source.environments.end());
 	scripts.insert(source.scripts.begin(), source.scripts.end());
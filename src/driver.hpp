@@ -24,6 +24,9 @@ struct driver {
 
 	void load_std(environment& env);
 	void load_std16(environment& env);
+	void load_std_compact(environment& env);
+	void load_std_short(environment& env);
+	void load_std_native(environment& env);
 	int parse(const std::string & f);
 	void scan_begin();
 	void scan_pause();
@@ -40,20 +43,27 @@ struct driver {
 		}
 
 		environment& import = environments[import_name];
+		// Imported bytecode is numbered after the environment's own.
+		unsigned base = env.bytecode_count;
 
 		for (auto& [name, def] : import.defines) {
 			env.defines[name] = def;
+			env.defines[name].bytecode += base;
 			env.bytecode_count++;
 		}
 
 		env.pool = import.pool;
 		env.section = import.section;
-		env.terminator = import.terminator;
+		env.terminator = import.terminator < 0 ? -1 : import.terminator + base;
+		env.runtime = import.runtime;
 	}
 
 	driver() {
 		load_std(environments["std"]);
 		load_std16(environments["std16"]);
+		load_std_compact(environments["std_compact"]);
+		load_std_short(environments["std_short"]);
+		load_std_native(environments["std_native"]);
 
 		typedefs["u8"].size = 1;
 		typedefs["u16"].size = 2;
@@ -0,0 +1,395 @@
+#include <charconv>
+#include <fmt/format.h>
+#include <map>
+#include "interpreter.hpp"
+#include "langs.hpp"
+#include "strings.hpp"
+
+using std::string;
+using fmt::format;
+
+// The most instructions one call of ExecuteScript may run before the script
+// is assumed never to yield.
+static const unsigned max_steps = 1000000;
+
+// How an instruction continues the script.
+enum class flow { NEXT, JUMP, YIELD, STOP };
+
+// Operations which combine a variable with another variable or a constant, and
+// store the result in a third. Division by zero gives all ones, as dividing
+// by repeated subtraction never finishes.
+static uint32_t add(uint32_t a, uint32_t b) { return a + b; }
+static uint32_t sub(uint32_t a, uint32_t b) { return a - b; }
+static uint32_t mul(uint32_t a, uint32_t b) { return a * b; }
+static uint32_t divide(uint32_t a, uint32_t b) { return b ? a / b : 0xFFFFFFFF; }
+static uint32_t band(uint32_t a, uint32_t b) { return a & b; }
+static uint32_t bor(uint32_t a, uint32_t b) { return a | b; }
+static uint32_t equ(uint32_t a, uint32_t b) { return a == b; }
+static uint32_t nequ(uint32_t a, uint32_t b) { return a != b; }
+static uint32_t lt(uint32_t a, uint32_t b) { return a < b; }
+static uint32_t gte(uint32_t a, uint32_t b) { return a >= b; }
+static uint32_t land(uint32_t a, uint32_t b) { return a && b; }
+static uint32_t lor(uint32_t a, uint32_t b) { return a || b; }
+
+static const struct {const char * handler; unsigned size; bool constant; uint32_t (*apply)(uint32_t, uint32_t);} operations[] = {
+	{"StdAdd",                 1, false, add},
+	{"StdSub",                 1, false, sub},
+	{"StdMul",                 1, false, mul},
+	{"StdDiv",                 1, false, divide},
+	{"StdBinaryAnd",           1, false, band},
+	{"StdBinaryOr",            1, false, bor},
+	{"StdEqu",                 1, false, equ},
+	{"StdNot",                 1, false, nequ},
+	{"StdLessThan",            1, false, lt},
+	{"StdGreaterThanEqu",      1, false, gte},
+	{"StdLogicalAnd",          1, false, land},
+	{"StdLogicalOr",           1, false, lor},
+	{"StdAddConst",            1, true,  add},
+	{"StdSubConst",            1, true,  sub},
+	{"StdMulConst",            1, true,  mul},
+	{"StdDivConst",            1, true,  divide},
+	{"StdBinaryAndConst",      1, true,  band},
+	{"StdBinaryOrConst",       1, true,  bor},
+	{"StdEquConst",            1, true,  equ},
+	{"StdNotConst",            1, true,  nequ},
+	{"StdLessThanConst",       1, true,  lt},
+	{"StdGreaterThanEquConst", 1, true,  gte},
+	{"StdAdd16",               2, false, add},
+	{"StdSub16",               2, false, sub},
+	{"StdMul16",               2, false, mul},
+	{"StdDiv16",               2, false, divide},
+	{"StdEqu16",               2, false, equ},
+	{"StdNot16",               2, false, nequ},
+	{"StdLogicalAnd16",        2, false, land},
+	{"StdLogicalOr16",         2, false, lor},
+	{"StdAddConst16",          2, true,  add},
+	{"StdSubConst16",          2, true,  sub},
+	{"StdMulConst16",          2, true,  mul},
+	{"StdDivConst16",          2, true,  divide},
+	{"StdEquConst16",          2, true,  equ},
+	{"StdNotConst16",          2, true,  nequ},
+};
+
+// Instructions which move a value between the pool and memory. LOAD reads
+// from the address in a variable, and STORE writes to it.
+enum class move { COPY, COPY_CONST, LOAD, LOAD_CONST, STORE, STORE_CONST };
+static const struct {const char * handler; unsigned size; move kind;} moves[] = {
+	{"StdCopy",         1, move::COPY},
+	{"StdCopyConst",    1, move::COPY_CONST},
+	{"StdLoad",         1, move::LOAD},
+	{"StdLoadConst",    1, move::LOAD_CONST},
+	{"StdStore",        1, move::STORE},
+	{"StdStoreConst",   1, move::STORE_CONST},
+	{"StdCopy16",       2, move::COPY},
+	{"StdCopyConst16",  2, move::COPY_CONST},
+	{"StdLoad16",       2, move::LOAD},
+	{"StdLoadConst16",  2, move::LOAD_CONST},
+	{"StdStore16",      2, move::STORE},
+	{"StdStoreConst16", 2, move::STORE_CONST},
+};
+
+// Jumps, whose destination may be a label, a script, or either written as a
+// displacement or far pointer.
+static const struct {const char * handler; bool conditional; bool inverted;} jumps[] = {
+	{"StdGoto",                   false, false},
+	{"StdGotoFar",                false, false},
+	{"StdGotoRel8",               false, false},
+	{"StdGotoConditional",        true,  false},
+	{"StdGotoConditionalFar",     true,  false},
+	{"StdGotoConditionalRel8",    true,  false},
+	{"StdGotoConditionalNot",     true,  true},
+	{"StdGotoConditionalNotFar",  true,  true},
+	{"StdGotoConditionalNotRel8", true,  true},
+};
+
+namespace {
+
+struct machine {
+	driver& drv;
+	profile& counts;
+	FILE * trace;
+	// The script which was started, which events are attributed to, even
+	// while it runs a subroutine or another script.
+	string root;
+	// Every form a jump's destination may be written in, for the labels of
+	// each script and for the scripts themselves.
+	std::map<string, std::map<string, size_t>> locals;
+	std::map<string, string> globals;
+
+	string name;
+	script * s;
+	environment * env;
+	size_t pc;
+	std::vector<uint8_t> pool;
+	// Memory outside of the pool. Addresses which cannot be known on the
+	// host, such as hardware registers, are kept by name.
+	std::map<string, uint8_t> memory;
+	// The text of each string in the pool, by every label which refers to it.
+	std::map<string, string> pooled;
+	// The script and instruction saved in each return address slot by
+	// call_sub.
+	std::map<uint32_t, std::pair<string, size_t>> returns;
+
+	machine(driver& drv, const string_pool& strings, profile& counts, FILE * trace)
+		: drv(drv), counts(counts), trace(trace) {
+		auto local = [](const string& label) { return format(fmt::runtime(lang.local_label), label); };
+		for (size_t i = 0; i < strings.strings.size(); i++) {
+			auto& symbols = strings.strings[i];
+			string label = format("EVScriptString{}", i);
+			pooled[label] = strings.decode(symbols);
+			for (size_t offset = 1; offset < symbols.size(); offset++) {
+				pooled[format("({} + {})", label, offset)] = strings.decode({symbols.begin() + offset, symbols.end()});
+			}
+		}
+		for (auto& [script_name, script] : drv.scripts) {
+			globals[script_name] = script_name;
+			globals[format(fmt::runtime(lang.far_pointer), script_name)] = script_name;
+			auto& labels = locals[script_name];
+			for (size_t i = 0; i < script.code.size(); i++) {
+				if (script.code[i].type != instype::LABEL) continue;
+				labels[local(script.code[i].name)] = i;
+				labels[format(fmt::runtime(lang.displacement), local(script.code[i].name))] = i;
+			}
+		}
+	}
+
+	void enter(const string& script_name, size_t index) {
+		name = script_name;
+		s = &drv.scripts[name];
+		env = &drv.environments[s->env];
+		pc = index;
+	}
+
+	// Numbers written by the compiler. Constants defined in assembly cannot
+	// be known, and are treated as 0.
+	uint32_t constant(const operand& op) {
+		uint32_t result = 0;
+		std::from_chars(op.value.data(), op.value.data() + op.value.size(), result);
+		return result;
+	}
+
+	uint8_t& byte(std::vector<uint8_t>& bytes, uint32_t address) {
+		if (address >= bytes.size()) bytes.resize(address + 1);
+		return bytes[address];
+	}
+	uint32_t read(std::vector<uint8_t>& bytes, uint32_t address, unsigned size) {
+		uint32_t result = 0;
+		for (unsigned i = 0; i < size; i++) result |= byte(bytes, address + i) << i * 8;
+		return result;
+	}
+	void write(std::vector<uint8_t>& bytes, uint32_t address, unsigned size, uint32_t value) {
+		for (unsigned i = 0; i < size; i++) byte(bytes, address + i) = value >> i * 8;
+	}
+	uint32_t get(const operand& op, unsigned size) { return read(pool, constant(op), size); }
+	void set(const operand& op, unsigned size, uint32_t value) { write(pool, constant(op), size, value); }
+
+	// Numbers are written in decimal, so that the same address is always
+	// found the same way.
+	string address(const operand& op) {
+		uint32_t result;
+		auto [end, ec] = std::from_chars(op.value.data(), op.value.data() + op.value.size(), result);
+		if (ec != std::errc() || end != op.value.data() + op.value.size()) return op.value;
+		return std::to_string(result);
+	}
+	uint32_t load(const string& base, unsigned size) {
+		uint32_t result = 0;
+		for (unsigned i = 0; i < size; i++) result |= memory[i ? format("{}+{}", base, i) : base] << i * 8;
+		return result;
+	}
+	void store(const string& base, unsigned size, uint32_t value) {
+		event("[{}] = {}", base, value & (size == 1 ? 0xFF : 0xFFFF));
+		for (unsigned i = 0; i < size; i++) memory[i ? format("{}+{}", base, i) : base] = value >> i * 8;
+	}
+
+	// The text of a string operand, or the operand itself if it is not a
+	// string.
+	string text(const operand& op) {
+		if (op.type == optype::STRING) return format("\"{}\"", op.value);
+		for (size_t i = 0; i < s->strings.size(); i++) {
+			if (op.value == format(fmt::runtime(lang.local_label), format("string_table{}", i))) {
+				return format("\"{}\"", s->strings[i].text);
+			}
+		}
+		if (auto str = pooled.find(op.value); str != pooled.end()) return format("\"{}\"", str->second);
+		return op.value;
+	}
+
+	template <typename... T>
+	void event(fmt::format_string<T...> message, T&&... args) {
+		if (trace) fmt::print(trace, "{}: {}\n", root, format(message, std::forward<T>(args)...));
+	}
+
+	flow jump(const operand& op) {
+		auto& labels = locals[name];
+		if (auto label = labels.find(op.value); label != labels.end()) {
+			pc = label->second;
+			return flow::JUMP;
+		}
+		if (auto target = globals.find(op.value); target != globals.end()) {
+			enter(target->second, 0);
+			counts.scripts[name]++;
+			return flow::JUMP;
+		}
+		err::warn("{} jumps to {}, which cannot be followed on the host", name, op.value);
+		event("goto {}", op.value);
+		return flow::STOP;
+	}
+
+	// Run the handler of a definition, given its operands.
+	flow execute(const string& def_name, const definition& def, const std::vector<operand>& ops) {
+		const string& handler = def.handler;
+		if (handler == "StdReturn") return flow::STOP;
+		if (handler == "StdYield") return flow::YIELD;
+		for (auto& form : jumps) {
+			if (handler != form.handler) continue;
+			if (form.conditional && (get(ops[0], 1) != 0) == form.inverted) return flow::NEXT;
+			return jump(ops.back());
+		}
+		if (handler == "StdLoopDec8" || handler == "StdLoopDec16") {
+			unsigned size = handler == "StdLoopDec8" ? 1 : 2;
+			uint32_t counter = get(ops[0], size) - 1;
+			set(ops[0], size, counter);
+			return counter & (size == 1 ? 0xFF : 0xFFFF) ? jump(ops[1]) : flow::NEXT;
+		}
+		if (handler == "StdJumpTable") {
+			// The minimum and count are assembled as single bytes.
+			uint8_t index = get(ops[0], 1) - constant(ops[1]);
+			return jump(index < (constant(ops[2]) & 0xFF) ? ops[4 + index] : ops[3]);
+		}
+		if (handler == "StdCallSub") {
+			returns[constant(ops[1])] = {name, pc + 1};
+			return jump(ops[0]);
+		}
+		if (handler == "StdReturnSub") {
+			auto address = returns.find(constant(ops[0]));
+			if (address == returns.end()) return flow::STOP;
+			enter(address->second.first, address->second.second);
+			return flow::JUMP;
+		}
+		for (auto& op : operations) {
+			if (handler != op.handler) continue;
+			uint32_t rhs = op.constant ? constant(ops[1]) : get(ops[1], op.size);
+			set(ops[2], op.size, op.apply(get(ops[0], op.size), rhs));
+			return flow::NEXT;
+		}
+		for (auto& m : moves) {
+			if (handler != m.handler) continue;
+			switch (m.kind) {
+			case move::COPY: set(ops[0], m.size, get(ops[1], m.size)); break;
+			case move::COPY_CONST: set(ops[0], m.size, constant(ops[1])); break;
+			case move::LOAD: set(ops[0], m.size, load(std::to_string(get(ops[1], 2)), m.size)); break;
+			case move::LOAD_CONST: set(ops[0], m.size, load(address(ops[1]), m.size)); break;
+			case move::STORE: store(std::to_string(get(ops[0], 2)), m.size, get(ops[1], m.size)); break;
+			case move::STORE_CONST: store(address(ops[0]), m.size, get(ops[1], m.size)); break;
+			}
+			return flow::NEXT;
+		}
+		// Compact forms pack a variable into the high nibble, and a variable
+		// or constant into the low nibble.
+		uint32_t packed = ops.size() ? constant(ops[0]) : 0;
+		uint32_t high = packed >> 4, low = packed & 15;
+		if (handler == "StdCopyQ") write(pool, high, 1, read(pool, low, 1));
+		else if (handler == "StdCopyConstQ") write(pool, high, 1, low);
+		else if (handler == "StdCopyConst16Q") write(pool, high, 2, low);
+		else if (handler == "StdAddConstQ") write(pool, high, 1, read(pool, high, 1) + low);
+		else if (handler == "StdSubConstQ") write(pool, high, 1, read(pool, high, 1) - low);
+		else {
+			// Anything else, such as callasm or a user's function, is
+			// assumed to have no effect on the script, and is only traced.
+			string args;
+			for (size_t i = 0; i < def.parameters.size() && i < ops.size(); i++) {
+				if (i) args += ", ";
+				if (def.parameters[i].type == ARG) args += std::to_string(get(ops[i], def.parameters[i].size));
+				else args += text(ops[i]);
+			}
+			event("{}({})", def_name, args);
+		}
+		return flow::NEXT;
+	}
+
+	// Run a superinstruction by running each of the handlers it calls, with
+	// their share of the operands.
+	flow execute_fused(const definition& def, const std::vector<operand>& ops) {
+		size_t next = 0;
+		flow result = flow::NEXT;
+		for (auto& handler : def.fused) {
+			for (auto& [part_name, part] : env->defines) {
+				if (part.handler != handler || !part.fused.empty()) continue;
+				size_t count = part.parameters.size();
+				std::vector<operand> part_ops(ops.begin() + next, ops.begin() + next + count);
+				next += count;
+				result = execute(part_name, part, part_ops);
+				break;
+			}
+		}
+		return result;
+	}
+
+	// Run the current script until it yields or stops.
+	flow step_frame() {
+		for (unsigned steps = 0; steps < max_steps; steps++) {
+			if (pc >= s->code.size()) return flow::STOP;
+			const instruction& ins = s->code[pc];
+			flow result = flow::NEXT;
+			switch (ins.type) {
+			case instype::LABEL:
+				counts.labels[name][ins.name]++;
+				break;
+			case instype::MACRO: {
+				string args;
+				for (auto& op : ins.operands) args += (args.empty() ? "" : ", ") + text(op);
+				event("{}({})", ins.opcode, args);
+				break;
+			}
+			case instype::DATA:
+				return flow::STOP;
+			case instype::BYTECODE: {
+				definition * def = env->get_define(ins.opcode);
+				if (!def) break;
+				result = def->fused.empty() ? execute(ins.opcode, *def, ins.operands) : execute_fused(*def, ins.operands);
+				break;
+			}
+			}
+			if (result == flow::STOP) return result;
+			if (result == flow::NEXT || result == flow::YIELD) pc++;
+			if (result == flow::YIELD) return result;
+		}
+		err::warn("{} ran for {} instructions without yielding", name, max_steps);
+		event("stopped");
+		return flow::STOP;
+	}
+};
+
+}
+
+profile interpret(driver& drv, const string_pool& strings, unsigned frames, FILE * trace) {
+	profile counts;
+	for (auto& [name, s] : drv.scripts) {
+		// Every label is listed, so that labels which were never reached can
+		// be told apart from those which were not measured.
+		counts.scripts[name] += 0;
+		for (auto& ins : s.code) if (ins.type == instype::LABEL) counts.labels[name][ins.name] += 0;
+	}
+
+	// Scripts are run in order of their names, so that traces can be
+	// compared.
+	std::map<string, script *> scripts;
+	for (auto& [name, s] : drv.scripts) scripts[name] = &s;
+	machine m(drv, strings, counts, trace);
+	for (auto& [name, s] : scripts) {
+		// Outlined subroutines have no statements of their own.
+		if (s->statements.empty()) continue;
+		m.pool.clear();
+		m.memory.clear();
+		m.returns.clear();
+		m.root = name;
+		m.enter(name, 0);
+		for (unsigned frame = 0; frame < frames; frame++) {
+			counts.scripts[m.name]++;
+			flow result = m.step_frame();
+			m.event("{}", result == flow::STOP ? "return" : "yield");
+			if (result == flow::STOP) break;
+		}
+	}
+	return counts;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdio.h>
+#include "driver.hpp"
+#include "profile.hpp"
+#include "strings.hpp"
+
+// Run every compiled script on the host, as the runtime would, and count how
+// often each script and label is reached. Each script starts with an empty
+// pool and is run by up to `frames` calls of ExecuteScript, stopping early if
+// it returns. Functions other than std's do nothing, since their handlers are
+// not known to the compiler. Outlined subroutines are only run when called.
+//
+// If `trace` is given, everything a script does which could be seen outside
+// of it is written there, one event per line: calls to other functions and
+// macros, with the values of their arguments, writes to memory, and each time
+// it yields or returns. Builds of the same scripts should have the same trace.
+profile interpret(driver& drv, const string_pool& strings, unsigned frames, FILE * trace = NULL);
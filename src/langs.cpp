@@ -9,6 +9,9 @@ language rgbasm = {
 	.label = "{}::",
 	.local_label = ".{}",
 	.section = "SECTION \"{} evscript section\", {}",
+	.bank_section = "{}, BANK[{}]",
+	.far_pointer = "(BANK({0}) << 16 | {0})",
+	.displacement = "{} - @ - 1",
 	.comment = "; {}",
 	.macro_open = "{} ",
 	.macro_end = "",
@@ -50,6 +53,9 @@ void readlang(std::string path) {
 		else if (key == "label") lang.label = value;
 		else if (key == "local_label") lang.local_label = value;
 		else if (key == "section") lang.section = value;
+		else if (key == "bank_section") lang.bank_section = value;
+		else if (key == "far_pointer") lang.far_pointer = value;
+		else if (key == "displacement") lang.displacement = value;
 		else if (key == "comment") lang.comment = value;
 		else if (key == "macro_open") lang.macro_open = value;
 		else if (key == "macro_end") lang.macro_end = value;
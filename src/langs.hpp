@@ -9,6 +9,9 @@ struct language {
 	std::string export_label; // {1}: label name
 	std::string local_label; // {1}: label name
 	std::string section; // {1}: name, {2}: optional type
+	std::string bank_section; // {1}: type, {2}: bank number
+	std::string far_pointer; // {1}: label, as a bank and address
+	std::string displacement; // {1}: label, from the byte after this one
 	std::string comment; // {1}: comment text
 	std::string macro_open; // {1}: macro name
 	std::string macro_end;
@@ -1,9 +1,18 @@
 #include <fmt/format.h>
 #include <getopt.h>
+#include <set>
 #include <stdio.h>
 #include "driver.hpp"
 #include "exception.hpp"
+#include "interpreter.hpp"
 #include "langs.hpp"
+#include "main.hpp"
+#include "passes.hpp"
+#include "profile.hpp"
+#include "report.hpp"
+#include "stats.hpp"
+#include "strings.hpp"
+#include "tables.hpp"
 
 // This string is generated in the makefile using the current git version.
 extern const char * version;
@@ -11,6 +20,47 @@ extern const char * version;
 static bool printed_help = false;
 // Output file for debug information. If this is present, debug labels are produced
 FILE * debug_file = NULL;
+unsigned unroll_threshold = 0;
+// Script statistics are printed to stats_file if a format is given.
+static stats_format stats = stats_format::NONE;
+static FILE * stats_file = NULL;
+// If present, a size profile is written here.
+static FILE * size_profile_file = NULL;
+// How to number the bytecode of generated tables.
+static opcode_order order = opcode_order::DECLARATION;
+// The number of superinstructions which may be added to a generated table.
+static unsigned superinstructions = 0;
+// If present, string literals are shared between scripts in a pool placed in
+// this type of section.
+static const char * string_pool_section = NULL;
+// Compress the strings in the pool.
+static bool compress_text = false;
+// The fewest bytes a shared subroutine must save to be outlined, or 0 to
+// disable outlining.
+static unsigned outline_threshold = 0;
+// If set, ROMX scripts are placed in banks of bank_size bytes, starting from
+// first_bank.
+static bool bank_pack = false;
+static unsigned first_bank = 1;
+static unsigned bank_size = 0x4000;
+// Execution counts used to place scripts, and how much of ROM0 the scripts
+// which run most often may be moved to.
+static const char * profile_path = NULL;
+static unsigned hot_rom0 = 0;
+profile execution_profile;
+pass_manager passes;
+// If present, the decisions changed by the profile are written here.
+static FILE * profile_report_file = NULL;
+// If present, scripts are run on the host for profile_frames frames each, and
+// the number of times each script and label was reached is written here.
+static FILE * emit_profile_file = NULL;
+static unsigned profile_frames = 60;
+// If present, the effects of running each script on the host are written here.
+static FILE * host_trace_file = NULL;
+// The settings which passes use if they are enabled without one.
+static const unsigned default_outline_threshold = 1;
+static const unsigned default_unroll_threshold = 32;
+static const unsigned default_superinstructions = 8;
 
 static void print_help(const char * program_name) {
 	if (!printed_help) {
@@ -22,19 +72,67 @@ static void print_help(const char * program_name) {
 			"\t-h --help     Show this message.\n"
 			//"\t-l --language Set the output langage. \"help\" lists all languages.\n"
 			"\t-o --output   Path to output file.\n"
-			"\t-V --version  Show version number.\n",
+			"\t-O            Optimization level: 0 (default), s for size, or 2 for speed.\n"
+			"\t-V --version  Show version number.\n"
+			"\t--time-report Print the time spent in each phase.\n"
+			"\t--mem-report  Print allocations made in each phase, and peak RSS.\n"
+			"\t--time-trace  Path to write phases to as a Chrome trace.\n"
+			"\t--stats       Print script sizes and opcode counts as \"text\" or \"json\".\n"
+			"\t--stats-file  Path to stats outfile. Defaults to stderr.\n"
+			"\t--size-profile Path to write bytes per source line as collapsed stacks.\n"
+			"\t--opcode-order Number generated tables by \"declaration\" or \"frequency\".\n"
+			"\t--superinstructions Maximum number of fused opcodes to add to a generated table.\n"
+			"\t--unroll-threshold Unroll repeat loops up to this many bytes.\n"
+			"\t--string-pool Share strings between scripts in sections of this type, such as ROM0.\n"
+			"\t--compress-text Compress the string pool, to be read using runtime/evstext.asm.\n"
+			"\t--outline-threshold Share repeated code between scripts if it saves this many bytes.\n"
+			"\t--bank-pack   Place ROMX scripts in banks starting from this one, using far jumps between banks.\n"
+			"\t--bank-size   Bytes of each bank available to --bank-pack. Defaults to 16384.\n"
+			"\t--profile     Path to the execution count of each script and label.\n"
+			"\t--hot-rom0    Move the most executed scripts to ROM0, up to this many bytes.\n"
+			"\t--profile-report Path to write the decisions changed by --profile.\n"
+			"\t--emit-profile Path to write execution counts from running each script on the host.\n"
+			"\t--profile-frames Number of times --emit-profile runs each script. Defaults to 60.\n"
+			"\t--host-trace  Path to write what each script does when run on the host.\n"
+			"\t--list-passes List each pass, and whether it will run.\n"
+			"\t--enable-pass Run a pass, whatever the optimization level.\n"
+			"\t--disable-pass Do not run a pass, whatever the optimization level.\n",
 			version, program_name
 		);
 	}
 }
 
-static const char shortopts[] = "d:hl:o:V";
+static const char shortopts[] = "d:hl:o:O:V";
 static struct option const longopts[] = {
 	{"debug",     required_argument, NULL, 'd'},
 	{"help",      no_argument,       NULL, 'h'},
 	//{"language",  required_argument, NULL, 'l'},
 	{"output",    required_argument, NULL, 'o'},
 	{"version",   no_argument,       NULL, 'V'},
+	{"time-report", no_argument,     NULL, 'T'},
+	{"mem-report",  no_argument,     NULL, 'M'},
+	{"time-trace",  required_argument, NULL, 'R'},
+	{"stats",       required_argument, NULL, 'S'},
+	{"stats-file",  required_argument, NULL, 'F'},
+	{"size-profile", required_argument, NULL, 'P'},
+	{"opcode-order", required_argument, NULL, 'N'},
+	{"superinstructions", required_argument, NULL, 'U'},
+	{"unroll-threshold", required_argument, NULL, 'L'},
+	{"string-pool", required_argument, NULL, 'G'},
+	{"compress-text", no_argument,   NULL, 'X'},
+	{"outline-threshold", required_argument, NULL, 'K'},
+	{"bank-pack",   required_argument, NULL, 'B'},
+	{"bank-size",   required_argument, NULL, 'Z'},
+	{"profile",     required_argument, NULL, 'I'},
+	{"hot-rom0",    required_argument, NULL, 'H'},
+	{"profile-report", required_argument, NULL, 'Q'},
+	{"emit-profile", required_argument, NULL, 'E'},
+	{"profile-frames", required_argument, NULL, 'Y'},
+	{"host-trace",  required_argument, NULL, 'J'},
+	{"list-passes", no_argument,     NULL, 'W'},
+	{"enable-pass", required_argument, NULL, 'A'},
+	{"disable-pass", required_argument, NULL, 'C'},
+	{NULL,        0,                 NULL, 0},
 };
 
 static FILE * fopen_output(const char * path) {
@@ -48,12 +146,23 @@ static FILE * fopen_output(const char * path) {
 	return outfile;
 }
 
+static unsigned parse_count(const char * arg, const char * what) {
+	char * end;
+	unsigned long count = strtoul(arg, &end, 10);
+	if (!*arg || *end || *arg == '-') err::error("Invalid {} \"{}\"", what, arg);
+	return count;
+}
+
 int main(int argc, char ** argv) {
 	// If stderr (fd 2) is a terminal, enable colored errors.
 	err::color = isatty(2);
 
 	// Options
 	FILE * outfile = NULL;
+	bool list_passes = false;
+	// Passes named by --enable-pass and --disable-pass, which override the
+	// optimization level.
+	std::vector<std::pair<std::string, bool>> pass_overrides;
 
 	for (char c; (c = getopt_long_only(argc, argv, shortopts, longopts, NULL)) != -1;) {
 		switch (c) {
@@ -89,12 +198,113 @@ int main(int argc, char ** argv) {
 			fmt::print(stderr, "evscript v{}\n", version);
 			exit(0);
 			break;
+		case 'T':
+			report::timing = true;
+			break;
+		case 'M':
+			report::memory = true;
+			break;
+		case 'R':
+			report::trace_file = fopen_output(optarg);
+			break;
+		case 'S':
+			if (std::string(optarg) == "json") stats = stats_format::JSON;
+			else if (std::string(optarg) == "text") stats = stats_format::TEXT;
+			else err::error("Unknown stats format \"{}\"", optarg);
+			break;
+		case 'F':
+			stats_file = fopen_output(optarg);
+			break;
+		case 'P':
+			size_profile_file = fopen_output(optarg);
+			break;
+		case 'N':
+			if (std::string(optarg) == "declaration") order = opcode_order::DECLARATION;
+			else if (std::string(optarg) == "frequency") order = opcode_order::FREQUENCY;
+			else err::error("Unknown opcode order \"{}\"", optarg);
+			break;
+		case 'U':
+			superinstructions = parse_count(optarg, "superinstruction count");
+			break;
+		case 'L':
+			unroll_threshold = parse_count(optarg, "unroll threshold");
+			break;
+		case 'G':
+			string_pool_section = optarg;
+			break;
+		case 'X':
+			compress_text = true;
+			break;
+		case 'O':
+			if (std::string(optarg) == "0") passes.set_level(opt_level::O0);
+			else if (std::string(optarg) == "s") passes.set_level(opt_level::Os);
+			else if (std::string(optarg) == "2") passes.set_level(opt_level::O2);
+			else err::error("Unknown optimization level \"{}\"", optarg);
+			break;
+		case 'K':
+			outline_threshold = parse_count(optarg, "outline threshold");
+			break;
+		case 'B':
+			bank_pack = true;
+			first_bank = parse_count(optarg, "bank number");
+			break;
+		case 'Z':
+			bank_size = parse_count(optarg, "bank size");
+			break;
+		case 'I':
+			profile_path = optarg;
+			break;
+		case 'H':
+			hot_rom0 = parse_count(optarg, "ROM0 size");
+			break;
+		case 'Q':
+			profile_report_file = fopen_output(optarg);
+			break;
+		case 'E':
+			emit_profile_file = fopen_output(optarg);
+			break;
+		case 'Y':
+			profile_frames = parse_count(optarg, "frame count");
+			break;
+		case 'J':
+			host_trace_file = fopen_output(optarg);
+			break;
+		case 'W':
+			list_passes = true;
+			break;
+		case 'A':
+		case 'C':
+			pass_overrides.emplace_back(optarg, c == 'A');
+			break;
 		}
 	}
 
+	// Settings for a pass enable it, unless it is disabled by name.
+	if (outline_threshold) passes.set("outline", true);
+	if (unroll_threshold) passes.set("unroll", true);
+	bool superinstructions_given = superinstructions;
+	if (superinstructions) passes.set("superinstructions", true);
+	for (auto& [name, enable] : pass_overrides) {
+		if (!passes.set(name, enable)) err::error("Unknown pass \"{}\"; --list-passes lists them", name);
+	}
+	if (list_passes) {
+		print_passes(stdout, passes);
+		exit(0);
+	}
+	if (!passes.runs("outline")) outline_threshold = 0;
+	else if (!outline_threshold) outline_threshold = default_outline_threshold;
+	if (!passes.runs("unroll")) unroll_threshold = 0;
+	else if (!unroll_threshold) unroll_threshold = default_unroll_threshold;
+	if (!passes.runs("superinstructions")) superinstructions = 0;
+	else if (!superinstructions) superinstructions = default_superinstructions;
+
 	if (argc == optind) err::error("No input file");
 	else if (argc != optind + 1) err::error("More than one input file given");
 	if (!outfile) err::error("No output file");
+	if (compress_text && !string_pool_section) err::error("--compress-text requires --string-pool");
+	if (bank_pack && first_bank == 0) err::error("--bank-pack cannot place scripts in bank 0");
+	if (hot_rom0 && !(bank_pack && profile_path)) err::error("--hot-rom0 requires --bank-pack and --profile");
+	if (profile_report_file && !profile_path) err::error("--profile-report requires --profile");
 
 	if (err::count > 0) {
 		print_help(argv[0]);
@@ -106,19 +316,100 @@ int main(int argc, char ** argv) {
 	driver drv;
 	int result = drv.parse(input_path);
 	if (result) return result;
+	err::check();
+
+	if (profile_path) {
+		execution_profile = read_profile(profile_path);
+		std::set<std::string> names;
+		for (auto& [name, count] : execution_profile.scripts) names.insert(name);
+		for (auto& [name, labels] : execution_profile.labels) names.insert(name);
+		for (auto& name : names) {
+			if (!drv.scripts.contains(name)) err::warn("Profile contains unknown script {}", name);
+		}
+	}
+
+	// Compile each script.
+	for (auto& [name, script] : drv.scripts) {
+		report::phase phase("compile", name);
+		environment& env = drv.environments[script.env];
+		script.compile(name, env);
+		optimize(script, env, passes);
+	}
+	// Pooled strings may be outlined, as they no longer belong to a script.
+	string_pool strings;
+	if (string_pool_section) {
+		report::phase phase("string pool");
+		strings = build_string_pool(drv, string_pool_section, compress_text);
+	}
+	if (outline_threshold) {
+		report::phase phase("outline");
+		outline_subroutines(drv, outline_threshold);
+	}
+	// Sizes must be final before placing scripts, other than superinstructions
+	// which only make them smaller.
+	if (bank_pack) {
+		report::phase phase("bank packing");
+		pack_banks(drv, first_bank, bank_size, execution_profile, hot_rom0);
+	}
+	// Levels add superinstructions to any environments which can use them,
+	// without warning about those which cannot.
+	if (superinstructions) {
+		report::phase phase("superinstructions");
+		synthesize_superinstructions(drv, superinstructions, execution_profile, superinstructions_given);
+	}
 
-	// Compile
+	if (emit_profile_file || host_trace_file) {
+		report::phase phase("interpret");
+		profile counts = interpret(drv, strings, profile_frames, host_trace_file);
+		if (emit_profile_file) write_profile(emit_profile_file, counts);
+	}
+
+	// Check the runtime options of each environment, and number their bytecode
+	// if the compiler generates the table.
+	bytecode_table table;
+	{
+		report::phase phase("tables");
+		table = build_table(drv, order);
+	}
+
+	// Output
 	fmt::print(outfile, "; Generated by the evscript bytecode compiler, written by Eievui\n");
 	// Produce constants for all bytecode.
-	for (auto& [env_name, env] : drv.environments) for (auto& [name, define] : env.defines) {
-		fmt::print(outfile, "DEF {}_{}_BYTECODE = {}\n", env_name, name, define.bytecode);
+	{
+		report::phase phase("constants");
+		for (auto& [env_name, env] : drv.environments) for (auto& [name, define] : env.defines) {
+			if (define.stripped) continue;
+			fmt::print(outfile, "DEF {}_{}_BYTECODE = {}\n", env_name, name, define.bytecode);
+		}
+	}
+	// Produce any tables and pool declarations required by the runtime.
+	{
+		report::phase phase("runtime");
+		print_table(outfile, table);
+		print_pools(outfile, drv);
 	}
 	// output any assembly code provided by the user.
 	for (auto& str : drv.assembly) {
 		fmt::print(outfile, "{}", str);
 	}
-	// Then compile each script.
-	for (auto& [name, script] : drv.scripts) {
-		script.compile(outfile, name, drv.environments[script.env]);
+	// Then print each script.
+	{
+		report::phase phase("emit");
+		for (auto& [name, script] : drv.scripts) {
+			script.emit(outfile, name, drv.environments[script.env]);
+		}
+		print_string_pool(outfile, strings);
+	}
+
+	if (stats != stats_format::NONE) print_stats(stats_file ? stats_file : stderr, drv, stats, strings);
+	if (size_profile_file) print_size_profile(size_profile_file, drv);
+	if (profile_report_file) {
+		for (auto& decision : execution_profile.decisions) fmt::print(profile_report_file, "{}\n", decision);
+	}
+
+	if (report::timing || report::memory) report::print_table(stderr);
+	if (report::trace_file) {
+		report::write_trace(report::trace_file);
+		fclose(report::trace_file);
 	}
 }
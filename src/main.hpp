@@ -1,4 +1,14 @@
 // Global configuration
 #include <stdio.h>
+#include "passes.hpp"
+#include "profile.hpp"
 
 extern FILE * debug_file;
+// When unrolling runs, repeat loops are unrolled if the result is no larger
+// than this many bytes, or than the loop itself.
+extern unsigned unroll_threshold;
+// The passes chosen by -O and --enable-pass, some of which are decided while
+// compiling.
+extern pass_manager passes;
+// Execution counts given by --profile, and the decisions which they changed.
+extern profile execution_profile;
@@ -0,0 +1,208 @@
+#include <fmt/format.h>
+#include "exception.hpp"
+#include "langs.hpp"
+#include "native.hpp"
+
+using std::string;
+using fmt::format;
+using fmt::print;
+
+// Operations which load their lhs into a, apply an instruction with the rhs,
+// and store a in their destination. Comparisons then set a to 1 unless the
+// given condition is true.
+static const struct {const char * handler; const char * instruction; const char * unless; bool constant;} operations[] = {
+	{"StdAdd",                 "add", nullptr, false},
+	{"StdSub",                 "sub", nullptr, false},
+	{"StdBinaryAnd",           "and", nullptr, false},
+	{"StdBinaryOr",            "or",  nullptr, false},
+	{"StdEqu",                 "cp",  "nz",    false},
+	{"StdNot",                 "cp",  "z",     false},
+	{"StdLessThan",            "cp",  "nc",    false},
+	{"StdGreaterThanEqu",      "cp",  "c",     false},
+	{"StdAddConst",            "add", nullptr, true},
+	{"StdSubConst",            "sub", nullptr, true},
+	{"StdBinaryAndConst",      "and", nullptr, true},
+	{"StdBinaryOrConst",       "or",  nullptr, true},
+	{"StdEquConst",            "cp",  "nz",    true},
+	{"StdNotConst",            "cp",  "z",     true},
+	{"StdLessThanConst",       "cp",  "nc",    true},
+	{"StdGreaterThanEquConst", "cp",  "c",     true},
+};
+
+void emit_native(FILE * out, const script& s, environment& env) {
+	definition * exec = env.get_define("exec_native");
+	if (!exec || exec->handler != "StdExecNative") {
+		err::fatal("Native scripts require exec_native; `use std_native;` in their environment");
+	}
+
+	// Threaded handlers continue by jumping to the next instruction, while
+	// ExecuteScript calls each one, so native code must leave the same way.
+	const char * leave = env.runtime.dispatch == dispatch_type::THREADED ? "jp EVScriptNext" : "ret";
+	string local_prefix = format(fmt::runtime(lang.local_label), "");
+	auto local = [](const string& label) { return format(fmt::runtime(lang.local_label), label); };
+	unsigned labels = 0;
+	auto generate_label = [&](const char * name) { return format("__native_{}_{}", name, labels++); };
+
+	// The variables which a holds and hl points to, if known, so that they
+	// are not loaded again. Anything may have changed after a label.
+	string in_a, in_hl;
+	auto forget = [&]() {
+		in_a.clear();
+		in_hl.clear();
+	};
+
+	// Bytecode which is run by the interpreter, followed by an exec_native
+	// which returns to native code.
+	struct trampoline {
+		string label;
+		const instruction * ins;
+		string resume;
+	};
+	std::vector<trampoline> trampolines;
+	auto enter = [&](const string& label, const yy::location& l) {
+		return instruction {
+			.type = instype::BYTECODE, .name = "exec_native", .opcode = "exec_native",
+			.operands = {{optype::VALUE, local(label), 2}},
+			.l = l,
+		};
+	};
+	// Run bytecode, then continue with the next native instruction.
+	auto interpret = [&](const instruction * ins) {
+		trampoline t = {generate_label("bytecode"), ins, generate_label("resume")};
+		print(out, "\tld hl, {}\n\t{}\n{}\n", local(t.label), leave, local(t.resume));
+		trampolines.push_back(t);
+		forget();
+	};
+
+	// Point hl at a variable in the pool, which is in de.
+	auto pointer = [&](const operand& op) {
+		if (in_hl == op.value) return;
+		print(out, "\tld hl, {}\n\tadd hl, de\n", op.value);
+		in_hl = op.value;
+	};
+	auto load = [&](const char * reg, const operand& op) {
+		if (reg == string("a") && in_a == op.value) return;
+		pointer(op);
+		print(out, "\tld {}, [hl]\n", reg);
+		if (reg == string("a")) in_a = op.value;
+	};
+	auto store = [&](const operand& op) {
+		pointer(op);
+		print(out, "\tld [hl], a\n");
+		in_a = op.value;
+	};
+	// Jump to a label within the script, or leave native code for another
+	// script's bytecode.
+	auto jump = [&](const char * condition, const char * inverse, const operand& target) {
+		if (target.value.starts_with(local_prefix)) {
+			print(out, "\tjp {}{}\n", condition ? format("{}, ", condition) : "", target.value);
+		} else {
+			if (inverse) print(out, "\tjr {}, :+\n", inverse);
+			print(out, "\tld hl, {}\n\t{}\n", target.value, leave);
+			if (inverse) print(out, ":\n");
+		}
+	};
+
+	string entry = generate_label("entry");
+	enter(entry, s.code.empty() ? yy::location() : s.code.front().l).emit(out, env);
+	print(out, "{}\n", local(entry));
+
+	for (auto& ins : s.code) {
+		if (ins.type == instype::LABEL) {
+			ins.emit(out, env);
+			forget();
+			continue;
+		}
+		definition * def = ins.type == instype::BYTECODE ? env.get_define(ins.opcode) : nullptr;
+		const string handler = def ? def->handler : "";
+		const auto& ops = ins.operands;
+		print(out, "\t; {}\n", ins.name.length() ? ins.name : ins.opcode);
+
+		bool done = true;
+		if (handler == "StdReturn") {
+			print(out, "\tjp StdReturn\n");
+			forget();
+		} else if (handler == "StdYield") {
+			// Save a pointer to bytecode which resumes after the yield.
+			trampoline t = {generate_label("yield"), nullptr, generate_label("resume")};
+			print(out, "\tld hl, {}\n\tjp StdYield\n{}\n", local(t.label), local(t.resume));
+			trampolines.push_back(t);
+			forget();
+		} else if (handler == "StdGoto") {
+			jump(nullptr, nullptr, ops[0]);
+			forget();
+		} else if (handler == "StdGotoConditional" || handler == "StdGotoConditionalNot") {
+			bool when = handler == "StdGotoConditional";
+			load("a", ops[0]);
+			print(out, "\tand a, a\n");
+			jump(when ? "nz" : "z", when ? "z" : "nz", ops[1]);
+		} else if (handler == "StdLoopDec8") {
+			pointer(ops[0]);
+			print(out, "\tdec [hl]\n");
+			if (in_a == ops[0].value) in_a.clear();
+			jump("nz", "z", ops[1]);
+		} else if (handler == "StdJumpTable") {
+			// Operands are the index, minimum and count, followed by the
+			// default target and a target for each index.
+			string table = generate_label("table");
+			load("a", ops[0]);
+			print(out, "\tsub a, {}\n\tcp a, {}\n\tjp nc, {}\n", ops[1].value, ops[2].value, ops[3].value);
+			// The index is doubled in 16 bits, since a table may have
+			// more than 128 entries.
+			print(
+				out,
+				"\tld l, a\n\tld h, 0\n\tadd hl, hl\n\tld bc, {0}\n\tadd hl, bc\n"
+				"\tld a, [hli]\n\tld h, [hl]\n\tld l, a\n\tjp hl\n{0}\n",
+				local(table)
+			);
+			for (size_t i = 4; i < ops.size(); i++) print(out, "\tdw {}\n", ops[i].value);
+			forget();
+		} else if (handler == "StdCallAsm") {
+			print(out, "\tpush de\n\tcall {}\n\tpop de\n", ops[0].value);
+			forget();
+		} else if (handler == "StdCopy") {
+			load("a", ops[1]);
+			store(ops[0]);
+		} else if (handler == "StdCopyConst") {
+			pointer(ops[0]);
+			print(out, "\tld [hl], {}\n", ops[1].value);
+			if (in_a == ops[0].value) in_a.clear();
+		} else {
+			done = false;
+			for (auto& op : operations) {
+				if (handler != op.handler) continue;
+				if (op.constant) {
+					load("a", ops[0]);
+					print(out, "\t{} a, {}\n", op.instruction, ops[1].value);
+				} else {
+					load("b", ops[1]);
+					load("a", ops[0]);
+					print(out, "\t{} a, b\n", op.instruction);
+				}
+				if (op.unless) print(out, "\tld a, 0\n\tjr {}, :+\n\tinc a\n:\n", op.unless);
+				in_a.clear();
+				store(ops[2]);
+				done = true;
+				break;
+			}
+		}
+		if (done) continue;
+
+		// Anything else is interpreted, which only works if it does not
+		// refer to labels in the script, as they are now native code.
+		for (auto& op : ops) {
+			if (op.type == optype::VALUE && op.value.starts_with(local_prefix) && !op.value.starts_with(local("string_table"))) {
+				err::error("{} cannot be used in a native script, as it refers to a label", ins.name);
+				break;
+			}
+		}
+		interpret(&ins);
+	}
+
+	for (auto& t : trampolines) {
+		print(out, "{}\n", local(t.label));
+		if (t.ins) t.ins->emit(out, env);
+		enter(t.resume, t.ins ? t.ins->l : yy::location()).emit(out, env);
+	}
+	err::check();
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdio.h>
+#include "types.hpp"
+
+// Write a script's compiled code as SM83 assembly. The script's label remains
+// bytecode, which enters the native code using exec_native from std_native,
+// so native scripts are run and resumed by ExecuteScript like any other.
+// Instructions with no native form are run as bytecode, returning to native
+// code with another exec_native.
+void emit_native(FILE * out, const script& s, environment& env);
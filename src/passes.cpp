@@ -0,0 +1,871 @@
+#include <algorithm>
+#include <charconv>
+#include <fmt/format.h>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include "cost.hpp"
+#include "langs.hpp"
+#include "passes.hpp"
+#include "report.hpp"
+
+using std::string;
+
+// Every pass which may be enabled, and the levels which enable it.
+static const struct {const char * name; bool O0, Os, O2; const char * description;} pass_list[] = {
+	{"loop-dec",          false, true,  true,  "Count repeat loops down using loop_dec8 and loop_dec16."},
+	{"rotate-loops",      false, true,  true,  "Check the condition of a for loop at the bottom."},
+	{"short-circuit",     false, true,  true,  "Branch on each side of && and || instead of combining them."},
+	{"jump-tables",       false, true,  true,  "Use jump_table for switches with dense cases."},
+	{"merge-tails",       false, true,  true,  "Merge identical code at the end of branches."},
+	{"compact",           false, true,  true,  "Use std_compact's packed operands."},
+	{"relax-branches",    false, true,  true,  "Use std_short's relative jumps."},
+	{"fast-forms",        false, false, true,  "Skip packed operands and relative jumps which are slower."},
+	{"unroll",            false, false, true,  "Unroll repeat loops up to --unroll-threshold bytes, 32 by default."},
+	{"outline",           false, true,  false, "Share repeated code between scripts, if it saves --outline-threshold bytes."},
+	{"superinstructions", false, false, true,  "Fuse common sequences, up to --superinstructions, 8 by default."},
+};
+
+void pass_manager::set_level(opt_level level) {
+	enabled.clear();
+	for (auto& pass : pass_list) {
+		bool enable = level == opt_level::O0 ? pass.O0 : level == opt_level::Os ? pass.Os : pass.O2;
+		if (enable) enabled.insert(pass.name);
+	}
+}
+
+bool pass_manager::set(const string& name, bool enable) {
+	for (auto& pass : pass_list) {
+		if (name != pass.name) continue;
+		if (enable) enabled.insert(name);
+		else enabled.erase(name);
+		return true;
+	}
+	return false;
+}
+
+void print_passes(FILE * out, const pass_manager& passes) {
+	for (auto& pass : pass_list) {
+		string levels;
+		if (pass.O0) levels += " -O0";
+		if (pass.Os) levels += " -Os";
+		if (pass.O2) levels += " -O2";
+		fmt::print(
+			out, "{:<18} {:<4}{:<13} {}\n",
+			pass.name, passes.runs(pass.name) ? "on" : "off", levels, pass.description
+		);
+	}
+}
+
+// Reads a value operand which the compiler wrote as a plain number, such as a
+// pool index or a literal. Constants and labels are left to the assembler.
+static std::optional<unsigned> number(const operand& op) {
+	if (op.type != optype::VALUE) return std::nullopt;
+	unsigned result;
+	auto [end, ec] = std::from_chars(op.value.data(), op.value.data() + op.value.size(), result);
+	if (ec != std::errc() || end != op.value.data() + op.value.size()) return std::nullopt;
+	return result;
+}
+
+void compact_operands(script& s, environment& env, bool fast) {
+	// The std definition, its handler, and the compact form which replaces
+	// it. `in_place` forms require the lhs to also be the destination.
+	const struct {const char * name; const char * handler; const char * compact; bool in_place;} forms[] = {
+		{"copy",         "StdCopy",        "copy_q",         false},
+		{"copy_const",   "StdCopyConst",   "copy_const_q",   false},
+		{"copy16_const", "StdCopyConst16", "copy16_const_q", false},
+		{"add_const",    "StdAddConst",    "add_const_q",    true},
+		{"sub_const",    "StdSubConst",    "sub_const_q",    true},
+	};
+
+	for (auto& ins : s.code) {
+		if (ins.type != instype::BYTECODE) continue;
+		for (auto& form : forms) {
+			if (ins.opcode != form.name) continue;
+			// A user's own definition may share the name, so only replace
+			// std's, and only if the environment has the compact form.
+			definition * def = env.get_define(form.name);
+			definition * compact = env.get_define(form.compact);
+			if (!def || def->handler != form.handler) break;
+			if (!compact || compact->type != DEF || compact->handler.empty()) break;
+			if (fast && cost::handler(*compact, env.runtime) > cost::handler(*def, env.runtime)) break;
+
+			std::optional<unsigned> high = number(ins.operands[0]);
+			std::optional<unsigned> low = number(ins.operands[1]);
+			if (form.in_place && number(ins.operands[2]) != high) break;
+			if (!high || !low || *high >= 16 || *low >= 16) break;
+
+			if (ins.name == ins.opcode) ins.name = form.compact;
+			ins.opcode = form.compact;
+			ins.operands = {{optype::VALUE, std::to_string(*high << 4 | *low), 1}};
+			break;
+		}
+	}
+}
+
+// Handlers which never continue to the following instruction.
+static const std::set<string> jump_handlers = {
+	"StdReturn", "StdGoto", "StdGotoFar", "StdJumpTable", "StdReturnSub",
+};
+
+// Estimate how often each instruction of a script runs: as often as the last
+// label before it, or the script itself if the label was not measured, and
+// never after a jump until the next label.
+static std::vector<uint64_t> instruction_counts(const string& name, const script& s, environment& env, const profile& counts) {
+	std::vector<uint64_t> result;
+	uint64_t current = counts.count(name);
+	for (auto& ins : s.code) {
+		if (ins.type == instype::LABEL) current = counts.label_count(name, ins.name).value_or(counts.count(name));
+		result.push_back(current);
+		definition * def = ins.type == instype::BYTECODE ? env.get_define(ins.opcode) : nullptr;
+		if (def && jump_handlers.contains(def->handler)) current = 0;
+	}
+	return result;
+}
+
+// Instructions are the same if they produce the same bytes.
+static string instruction_key(const instruction& ins) {
+	string result = ins.opcode;
+	for (auto& op : ins.operands) {
+		result += fmt::format("\n{}:{}:{}", op.type == optype::STRING, op.size, op.value);
+	}
+	return result;
+}
+
+void merge_tails(script& s, environment& env) {
+	auto handler = [&](const instruction& ins) {
+		definition * def = env.get_define(ins.opcode);
+		return ins.type == instype::BYTECODE && def ? def->handler : string();
+	};
+	auto local_label = [](const string& name) {
+		return fmt::format(fmt::runtime(lang.local_label), name);
+	};
+	// Only plain instructions may be merged. A label means another path
+	// joins partway through, and a jump ends the path.
+	auto mergeable = [&](const instruction& ins) {
+		return ins.type == instype::BYTECODE && !jump_handlers.contains(handler(ins));
+	};
+
+	std::vector<instruction>& code = s.code;
+	unsigned labels = 0;
+	for (bool changed = true; changed;) {
+		changed = false;
+		for (size_t p = 0; p < code.size() && !changed; p++) {
+			if (code[p].type != instype::LABEL || (p && code[p - 1].type == instype::LABEL)) continue;
+			std::set<string> targets;
+			for (size_t q = p; q < code.size() && code[q].type == instype::LABEL; q++) {
+				targets.insert(local_label(code[q].name));
+			}
+
+			// A goto to the following instruction does nothing.
+			if (p && handler(code[p - 1]) == "StdGoto" && targets.contains(code[p - 1].operands[0].value)) {
+				s.stats.merged_bytes += code[p - 1].size();
+				code.erase(code.begin() + p - 1);
+				changed = true;
+				break;
+			}
+
+			// Find the end of each path into this point: the instruction
+			// before it if that falls through, and each goto.
+			std::vector<size_t> ends;
+			if (p && mergeable(code[p - 1])) ends.push_back(p);
+			for (size_t g = 0; g < code.size(); g++) {
+				if (handler(code[g]) == "StdGoto" && targets.contains(code[g].operands[0].value)) {
+					ends.push_back(g);
+				}
+			}
+			if (ends.size() < 2) continue;
+
+			// Keep the first path's tail, and point every other path
+			// which ends the same way into it.
+			size_t kept = ends[0];
+			std::map<size_t, string> entry_labels;
+			std::map<size_t, size_t> removed;
+			for (size_t i = 1; i < ends.size(); i++) {
+				size_t end = ends[i];
+				size_t length = 0;
+				while (
+					length < kept && length < end
+					&& mergeable(code[kept - 1 - length]) && mergeable(code[end - 1 - length])
+					&& instruction_key(code[kept - 1 - length]) == instruction_key(code[end - 1 - length])
+				) length++;
+				if (!length) continue;
+				size_t entry = kept - length;
+				if (!entry_labels.contains(entry)) {
+					string label;
+					do label = fmt::format("__tail_{}", labels++);
+					while (std::any_of(code.begin(), code.end(), [&](const instruction& ins) {
+						return ins.type == instype::LABEL && ins.name == label;
+					}));
+					entry_labels[entry] = label;
+					s.stats.labels++;
+				}
+				code[end].operands[0].value = local_label(entry_labels[entry]);
+				removed[end - length] = end;
+			}
+			if (entry_labels.empty()) continue;
+
+			std::vector<instruction> result;
+			for (size_t i = 0; i < code.size(); i++) {
+				if (removed.contains(i)) {
+					for (size_t j = i; j < removed[i]; j++) s.stats.merged_bytes += code[j].size();
+					i = removed[i] - 1;
+					continue;
+				}
+				if (entry_labels.contains(i)) {
+					result.push_back({.type = instype::LABEL, .name = entry_labels[i], .l = code[i].l, .context = code[i].context});
+				}
+				result.push_back(std::move(code[i]));
+			}
+			code = std::move(result);
+			changed = true;
+		}
+	}
+}
+
+void optimize(script& s, environment& env, const pass_manager& passes) {
+	if (passes.runs("merge-tails")) merge_tails(s, env);
+	// Native code has its own forms of these.
+	if (!s.native) {
+		bool fast = passes.runs("fast-forms");
+		if (passes.runs("compact")) compact_operands(s, env, fast);
+		if (passes.runs("relax-branches")) relax_branches(s, env, fast);
+	}
+	s.measure();
+}
+
+// Handlers which always continue to the following instruction, and do not
+// touch the stack left by ExecuteScript. Only these may begin a
+// superinstruction; the last instruction of one may be anything.
+static const std::set<string> fallthrough_handlers = {
+	"StdCallAsm", "StdCallAsmFar",
+	"StdAdd", "StdSub", "StdMul", "StdDiv", "StdBinaryAnd", "StdBinaryOr",
+	"StdEqu", "StdNot", "StdLessThan", "StdGreaterThanEqu", "StdLogicalAnd",
+	"StdLogicalOr", "StdAddConst", "StdSubConst", "StdMulConst", "StdDivConst",
+	"StdBinaryAndConst", "StdBinaryOrConst", "StdEquConst", "StdNotConst",
+	"StdLessThanConst", "StdGreaterThanEquConst", "StdCopy", "StdLoad",
+	"StdStore", "StdCopyConst", "StdLoadConst", "StdStoreConst",
+	"StdAdd16", "StdSub16", "StdMul16", "StdDiv16", "StdEqu16", "StdNot16",
+	"StdLogicalAnd16", "StdLogicalOr16", "StdAddConst16", "StdSubConst16",
+	"StdMulConst16", "StdDivConst16", "StdEquConst16", "StdNotConst16",
+	"StdCopy16", "StdLoad16", "StdStore16", "StdCopyConst16", "StdLoadConst16",
+	"StdStoreConst16",
+	"StdCopyQ", "StdCopyConstQ", "StdCopyConst16Q", "StdAddConstQ", "StdSubConstQ",
+};
+
+// The longest sequence of instructions fused into one.
+static const size_t max_fused = 3;
+
+bool supports_superinstructions(const environment& env) {
+	// Handlers are called from the superinstruction, which only works if
+	// they return rather than jumping to the next instruction themselves.
+	return env.runtime.dispatch == dispatch_type::CALL && env.generates_table();
+}
+
+void synthesize_superinstructions(driver& drv, unsigned budget, profile& counts, bool warn_unsupported) {
+	std::map<string, environment *> environments;
+	for (auto& [name, script] : drv.scripts) {
+		environments[script.env] = &drv.environments[script.env];
+	}
+	// Environments which cannot use superinstructions are left alone.
+	std::erase_if(environments, [&](auto& entry) {
+		if (supports_superinstructions(*entry.second)) return false;
+		if (warn_unsupported) err::warn(
+			"Superinstructions require `dispatch = \"call\";` and a generated "
+			"table, but environment {} does not use them", entry.first
+		);
+		return true;
+	});
+
+	// Returns the length of the sequence of instructions starting at `i`
+	// which may be fused, up to `max_fused`.
+	auto fusable = [&](script& s, size_t i) {
+		environment& env = drv.environments[s.env];
+		size_t length = 0;
+		// Native scripts inline their instructions instead.
+		if (s.native || !environments.contains(s.env)) return length;
+		for (; length < max_fused && i + length < s.code.size(); length++) {
+			instruction& ins = s.code[i + length];
+			if (ins.type != instype::BYTECODE) break;
+			definition * def = env.get_define(ins.opcode);
+			if (!def || def->type != DEF || def->handler.empty()) break;
+			// Anything may end a superinstruction, but nothing may
+			// follow a handler which might not fall through.
+			if (!fallthrough_handlers.contains(def->handler)) {
+				length++;
+				break;
+			}
+		}
+		return length;
+	};
+
+	auto sequence_name = [](const std::vector<string>& sequence) {
+		string name = sequence[0];
+		for (size_t i = 1; i < sequence.size(); i++) name += "__" + sequence[i];
+		return name;
+	};
+
+	for (unsigned n = 0; n < budget; n++) {
+		// Count every sequence of two or more instructions, and how often
+		// the profile says they run. Overlapping sequences are counted
+		// twice, but this is only used to rank them.
+		std::map<std::vector<string>, unsigned> uses;
+		std::map<std::vector<string>, uint64_t> runs;
+		for (auto& [name, s] : drv.scripts) {
+			std::vector<uint64_t> executions = instruction_counts(name, s, drv.environments[s.env], counts);
+			for (size_t i = 0; i < s.code.size(); i++) {
+				size_t length = fusable(s, i);
+				std::vector<string> sequence;
+				for (size_t j = 0; j < length; j++) {
+					sequence.push_back(s.code[i + j].opcode);
+					if (j) {
+						uses[sequence]++;
+						runs[sequence] += executions[i];
+					}
+				}
+			}
+		}
+
+		// Pick the sequence which saves the most dispatches, as run in the
+		// profile and then as written. One which is only used once saves a
+		// byte, but costs more than that in its handler.
+		auto pick = [&](bool profiled) {
+			const std::vector<string> * best = nullptr;
+			std::pair<uint64_t, unsigned> best_saved = {0, 0};
+			for (auto& [sequence, count] : uses) {
+				std::pair<uint64_t, unsigned> saved = {
+					profiled ? runs[sequence] * (sequence.size() - 1) : 0,
+					count * (sequence.size() - 1),
+				};
+				if (count >= 2 && saved > best_saved) {
+					best = &sequence;
+					best_saved = saved;
+				}
+			}
+			return best;
+		};
+		const std::vector<string> * best = pick(!counts.empty());
+		if (!best) break;
+		std::vector<string> sequence = *best;
+		if (const std::vector<string> * unprofiled = pick(false); unprofiled && unprofiled != best) {
+			counts.decisions.push_back(fmt::format(
+				"Fused {}, which ran {} times, rather than {}, which ran {} times and appears {} times",
+				sequence_name(sequence), runs[sequence],
+				sequence_name(*unprofiled), runs[*unprofiled], uses[*unprofiled]
+			));
+		}
+
+		string name = sequence_name(sequence);
+		for (auto& [env_name, env] : environments) {
+			if (env->defines.contains(name)) {
+				err::warn("Not adding superinstruction {}, since {} already defines it", name, env_name);
+				return;
+			}
+		}
+		for (auto& [env_name, env] : environments) {
+			// Only environments which provide every part can use it.
+			bool provided = true;
+			for (auto& part : sequence) {
+				definition * def = env->get_define(part);
+				provided = provided && def && def->type == DEF;
+			}
+			if (!provided) continue;
+
+			definition fused = {DEF, env->bytecode_count++};
+			fused.handler = "EVScriptSuper_" + name;
+			for (auto& part : sequence) {
+				definition& def = env->defines[part];
+				fused.parameters.insert(fused.parameters.end(), def.parameters.begin(), def.parameters.end());
+				fused.fused.push_back(def.handler);
+			}
+			env->defines[name] = fused;
+		}
+
+		// Replace each occurrence, from the start of each script.
+		for (auto& [script_name, s] : drv.scripts) {
+			std::vector<instruction> code;
+			for (size_t i = 0; i < s.code.size(); i++) {
+				bool match = fusable(s, i) >= sequence.size();
+				for (size_t j = 0; match && j < sequence.size(); j++) {
+					match = s.code[i + j].opcode == sequence[j];
+				}
+				if (!match) {
+					code.push_back(std::move(s.code[i]));
+					continue;
+				}
+				instruction ins = s.code[i];
+				ins.name = ins.opcode = name;
+				for (size_t j = 1; j < sequence.size(); j++) {
+					auto& operands = s.code[i + j].operands;
+					ins.operands.insert(ins.operands.end(), operands.begin(), operands.end());
+				}
+				code.push_back(std::move(ins));
+				i += sequence.size() - 1;
+			}
+			s.code = std::move(code);
+			s.measure();
+		}
+	}
+}
+
+// The longest sequence of instructions moved into a subroutine.
+static const size_t max_outlined = 64;
+
+void outline_subroutines(driver& drv, unsigned threshold) {
+	const string local_prefix = fmt::format(fmt::runtime(lang.local_label), "");
+
+	// Labels and macros stay in their script, as does anything which refers
+	// to a local label. Subroutines cannot be nested, since there is only
+	// one slot for the return address.
+	auto outlinable = [&](const instruction& ins) {
+		if (ins.type != instype::BYTECODE) return false;
+		if (ins.opcode == "call_sub" || ins.opcode == "return_sub") return false;
+		for (auto& op : ins.operands) {
+			if (op.type == optype::VALUE && op.value.starts_with(local_prefix)) return false;
+		}
+		return true;
+	};
+
+	auto definition_size = [](const definition& def) {
+		unsigned size = 1;
+		for (auto& param : def.parameters) size += param.size;
+		return size;
+	};
+
+	// Subroutines are only shared within an environment, since bytecode may
+	// differ between them. Sort scripts by name so that subroutines are
+	// numbered the same between builds.
+	std::map<string, std::vector<script *>> groups;
+	{
+		std::map<string, script *> scripts;
+		for (auto& [name, s] : drv.scripts) scripts[name] = &s;
+		for (auto& [name, s] : scripts) {
+			environment& env = drv.environments[s->env];
+			if (!env.get_define("call_sub") || !env.get_define("return_sub")) continue;
+			if (env.pool < 2 || s->stats.peak_pool > env.pool - 2) continue;
+			if (s->native) continue;
+			groups[s->env].push_back(s);
+		}
+	}
+
+	std::vector<std::pair<string, script>> subroutines;
+	for (auto& [env_name, group] : groups) {
+		environment& env = drv.environments[env_name];
+		string slot = std::to_string(env.pool - 2);
+		long call_size = definition_size(*env.get_define("call_sub"));
+		long return_size = definition_size(*env.get_define("return_sub"));
+
+		for (;;) {
+			// Number each distinct instruction, and hash every prefix of
+			// each script so that any sequence can be hashed at once.
+			const uint64_t base = 1000003;
+			std::unordered_map<string, unsigned> ids;
+			struct prefix {
+				std::vector<uint64_t> hash = {0};
+				std::vector<unsigned> bytes = {0};
+				// The number of outlinable instructions from here.
+				std::vector<size_t> run;
+			};
+			std::vector<prefix> prefixes(group.size());
+			std::vector<uint64_t> powers = {1};
+			for (size_t i = 0; i < max_outlined; i++) powers.push_back(powers.back() * base);
+			for (size_t n = 0; n < group.size(); n++) {
+				auto& code = group[n]->code;
+				prefix& p = prefixes[n];
+				for (auto& ins : code) {
+					auto [id, inserted] = ids.emplace(instruction_key(ins), ids.size());
+					p.hash.push_back(p.hash.back() * base + id->second + 1);
+					p.bytes.push_back(p.bytes.back() + ins.size());
+				}
+				p.run.resize(code.size() + 1);
+				for (size_t i = code.size(); i-- > 0;) {
+					p.run[i] = outlinable(code[i]) ? p.run[i + 1] + 1 : 0;
+				}
+			}
+
+			// Find the sequence which saves the most bytes. Each
+			// occurrence is replaced by a call, and the subroutine needs
+			// a return. Overlapping occurrences only count once.
+			long best_saved = 0;
+			size_t best_script = 0, best_start = 0, best_length = 0;
+			for (size_t length = 2; length <= max_outlined; length++) {
+				struct occurrence {
+					unsigned count = 0;
+					// The first occurrence, and the end of the last.
+					size_t script, start;
+					size_t last_script, last_end;
+				};
+				std::unordered_map<uint64_t, occurrence> occurrences;
+				for (size_t n = 0; n < group.size(); n++) {
+					prefix& p = prefixes[n];
+					for (size_t i = 0; i + length < p.hash.size(); i++) {
+						if (p.run[i] < length) continue;
+						uint64_t hash = p.hash[i + length] - p.hash[i] * powers[length];
+						occurrence& o = occurrences[hash];
+						if (o.count && o.last_script == n && i < o.last_end) continue;
+						if (!o.count) {
+							o.script = n;
+							o.start = i;
+						}
+						o.count++;
+						o.last_script = n;
+						o.last_end = i + length;
+					}
+				}
+				for (auto& [hash, o] : occurrences) {
+					if (o.count < 2) continue;
+					long bytes = prefixes[o.script].bytes[o.start + length] - prefixes[o.script].bytes[o.start];
+					long saved = o.count * (bytes - call_size) - bytes - return_size;
+					if (saved > best_saved) {
+						best_saved = saved;
+						best_script = o.script;
+						best_start = o.start;
+						best_length = length;
+					}
+				}
+			}
+			if (best_saved < long(threshold) || best_saved <= 0) break;
+
+			auto& source = group[best_script]->code;
+			std::vector<instruction> sequence(
+				source.begin() + best_start, source.begin() + best_start + best_length
+			);
+			string name = fmt::format("EVScriptSubroutine{}", subroutines.size());
+
+			// Compare the instructions themselves, in case of a hash
+			// collision.
+			auto matches = [&](const std::vector<instruction>& code, size_t i) {
+				if (i + sequence.size() > code.size()) return false;
+				for (size_t j = 0; j < sequence.size(); j++) {
+					if (!outlinable(code[i + j]) || instruction_key(code[i + j]) != instruction_key(sequence[j])) return false;
+				}
+				return true;
+			};
+			unsigned uses = 0;
+			for (auto * s : group) {
+				for (size_t i = 0; i < s->code.size(); i++) {
+					if (matches(s->code, i)) {
+						uses++;
+						i += sequence.size() - 1;
+					}
+				}
+			}
+			if (uses < 2) break;
+
+			// Replace each occurrence with a call.
+			for (auto * s : group) {
+				std::vector<instruction> code;
+				for (size_t i = 0; i < s->code.size(); i++) {
+					if (!matches(s->code, i)) {
+						code.push_back(std::move(s->code[i]));
+						continue;
+					}
+					code.push_back({
+						.type = instype::BYTECODE, .name = "call_sub", .opcode = "call_sub",
+						.operands = {{optype::VALUE, name, 2}, {optype::VALUE, slot, 1}},
+						.l = s->code[i].l, .context = s->code[i].context,
+					});
+					i += sequence.size() - 1;
+				}
+				s->code = std::move(code);
+				s->measure();
+			}
+
+			script subroutine;
+			subroutine.env = env_name;
+			subroutine.section = "ROM0";
+			subroutine.code = std::move(sequence);
+			// The return is attributed to the last instruction it follows.
+			instruction& last = subroutine.code.back();
+			subroutine.code.push_back({
+				.type = instype::BYTECODE, .name = "return_sub", .opcode = "return_sub",
+				.operands = {{optype::VALUE, slot, 1}},
+				.l = last.l, .context = last.context,
+			});
+			subroutine.measure();
+			subroutines.emplace_back(name, std::move(subroutine));
+		}
+	}
+
+	for (auto& [name, subroutine] : subroutines) {
+		drv.scripts[name] = std::move(subroutine);
+	}
+}
+
+// Jumps which may be made to another script, and their far forms.
+static const struct {const char * handler; const char * far; const char * far_handler;} far_forms[] = {
+	{"StdGoto",               "goto_far",                 "StdGotoFar"},
+	{"StdGotoConditional",    "goto_conditional_far",     "StdGotoConditionalFar"},
+	{"StdGotoConditionalNot", "goto_conditional_not_far", "StdGotoConditionalNotFar"},
+};
+
+// Group scripts of the given sizes which jump to each other most often, and
+// place the groups in banks of `bank_size` bytes. Returns the bank of each
+// script, counting from 0.
+static std::map<string, unsigned> place_groups(
+	const std::map<string, unsigned>& sizes, const std::map<string, std::vector<string>>& targets,
+	const profile& counts, unsigned bank_size
+) {
+	// Count the jumps between each pair of scripts which are placed. A jump
+	// made by a script which runs often is worth more than one which may
+	// never be reached.
+	std::map<std::pair<string, string>, uint64_t> references;
+	for (auto& [name, size] : sizes) {
+		for (auto& target : targets.at(name)) {
+			if (target == name || !sizes.contains(target)) continue;
+			references[std::minmax(name, target)] += 1 + counts.count(name);
+		}
+	}
+
+	// Group the scripts which jump between each other most often, as long
+	// as each group still fits in a bank.
+	std::map<string, string> parents;
+	std::map<string, std::vector<string>> groups;
+	for (auto& [name, size] : sizes) {
+		parents[name] = name;
+		groups[name] = {name};
+	}
+	auto find = [&](string name) {
+		while (parents[name] != name) name = parents[name];
+		return name;
+	};
+	auto group_size = [&](const string& root) {
+		unsigned size = 0;
+		for (auto& name : groups[root]) size += sizes.at(name);
+		return size;
+	};
+	std::vector<std::pair<std::pair<string, string>, uint64_t>> edges(references.begin(), references.end());
+	std::stable_sort(edges.begin(), edges.end(), [](auto& a, auto& b) { return a.second > b.second; });
+	for (auto& [pair, count] : edges) {
+		string a = find(pair.first);
+		string b = find(pair.second);
+		if (a == b || group_size(a) + group_size(b) > bank_size) continue;
+		parents[b] = a;
+		groups[a].insert(groups[a].end(), groups[b].begin(), groups[b].end());
+		groups.erase(b);
+	}
+
+	// Place the groups which run most often first, so that they share the
+	// first bank, then the largest, each in the first bank with room.
+	struct placement {
+		uint64_t executions = 0;
+		unsigned size;
+		string root;
+	};
+	std::vector<placement> order;
+	for (auto& [root, members] : groups) {
+		placement p = {.size = group_size(root), .root = root};
+		for (auto& name : members) p.executions += counts.count(name);
+		order.push_back(p);
+	}
+	std::stable_sort(order.begin(), order.end(), [](auto& a, auto& b) {
+		if (a.executions != b.executions) return a.executions > b.executions;
+		return a.size > b.size;
+	});
+	std::vector<unsigned> banks;
+	std::map<string, unsigned> result;
+	for (auto& [executions, size, root] : order) {
+		size_t bank = 0;
+		while (bank < banks.size() && banks[bank] + size > bank_size) bank++;
+		if (bank == banks.size()) banks.push_back(0);
+		banks[bank] += size;
+		for (auto& name : groups[root]) result[name] = bank;
+	}
+	return result;
+}
+
+void pack_banks(driver& drv, unsigned first_bank, unsigned bank_size, profile& counts, unsigned rom0_bytes) {
+	auto section_type = [&](script& s) {
+		return s.section.length() ? s.section : drv.environments[s.env].section;
+	};
+
+	// If an instruction jumps to another script, return its name.
+	auto jump_target = [&](script& s, const instruction& ins) -> string {
+		if (ins.type != instype::BYTECODE || ins.operands.empty()) return "";
+		definition * def = drv.environments[s.env].get_define(ins.opcode);
+		if (!def) return "";
+		for (auto& form : far_forms) {
+			if (def->handler != form.handler) continue;
+			if (drv.scripts.contains(ins.operands.back().value)) return ins.operands.back().value;
+		}
+		return "";
+	};
+
+	// Only ROMX scripts of a known size are placed. Scripts containing
+	// macros, and native scripts, are left for the linker. Sort scripts by name so that they are
+	// placed the same between builds.
+	std::map<string, script *> scripts;
+	for (auto& [name, s] : drv.scripts) scripts[name] = &s;
+	std::map<string, unsigned> sizes;
+	for (auto& [name, s] : scripts) {
+		if (section_type(*s) != "ROMX" || s->stats.macros || s->native) continue;
+		// Assume that every jump to another script is far, which is at
+		// most one byte larger than the near jump it replaces.
+		unsigned size = s->stats.bytecode_bytes + s->stats.string_bytes;
+		for (auto& ins : s->code) if (jump_target(*s, ins).length()) size++;
+		if (size > bank_size) {
+			err::warn("{} is {} bytes, which does not fit in a bank of {} bytes", name, size, bank_size);
+			continue;
+		}
+		sizes[name] = size;
+	}
+
+	// Move the scripts which run most often for their size to ROM0, where
+	// they never need a bank switch, until `rom0_bytes` is used up.
+	std::vector<string> hot;
+	for (auto& [name, size] : sizes) if (counts.count(name)) hot.push_back(name);
+	std::stable_sort(hot.begin(), hot.end(), [&](auto& a, auto& b) {
+		return counts.count(a) * sizes[b] > counts.count(b) * sizes[a];
+	});
+	for (auto& name : hot) {
+		if (sizes[name] > rom0_bytes) continue;
+		rom0_bytes -= sizes[name];
+		scripts[name]->section = "ROM0";
+		counts.decisions.push_back(fmt::format(
+			"Moved {} to ROM0, since it ran {} times in {} bytes", name, counts.count(name), sizes[name]
+		));
+		sizes.erase(name);
+	}
+
+	// Find where each script jumps to, then place them with and without
+	// the profile, to report where it made a difference.
+	std::map<string, std::vector<string>> targets;
+	for (auto& [name, size] : sizes) {
+		std::vector<string>& jumps = targets[name];
+		for (auto& ins : scripts[name]->code) {
+			string target = jump_target(*scripts[name], ins);
+			if (target.length()) jumps.push_back(target);
+		}
+	}
+	std::map<string, unsigned> banks = place_groups(sizes, targets, counts, bank_size);
+	std::map<string, unsigned> unprofiled = counts.empty() ? banks : place_groups(sizes, targets, {}, bank_size);
+	for (auto& [name, bank] : banks) {
+		scripts[name]->bank = first_bank + bank;
+		if (unprofiled[name] != bank) {
+			counts.decisions.push_back(fmt::format(
+				"Placed {} in bank {} rather than bank {}", name, first_bank + bank, first_bank + unprofiled[name]
+			));
+		}
+	}
+
+	// Now that banks are known, jumps only need to be far if they may cross
+	// banks. Scripts in ROM0 can always be reached, but a jump from ROM0
+	// cannot know which bank is loaded.
+	for (auto& [name, s] : scripts) {
+		environment& env = drv.environments[s->env];
+		for (auto& ins : s->code) {
+			string target_name = jump_target(*s, ins);
+			if (target_name.empty() || target_name == name) continue;
+			script& target = drv.scripts[target_name];
+			if (section_type(target) == "ROM0") continue;
+			if (target.bank >= 0 && target.bank == s->bank) continue;
+
+			definition * def = env.get_define(ins.opcode);
+			for (auto& form : far_forms) {
+				if (def->handler != form.handler) continue;
+				definition * far = env.get_define(form.far);
+				if (!far || far->handler != form.far_handler) {
+					err::error("{} may jump to another bank, but {} is not defined", name, form.far);
+					break;
+				}
+				if (ins.name == ins.opcode) ins.name = form.far;
+				ins.opcode = form.far;
+				ins.operands.back() = {
+					optype::VALUE, fmt::format(fmt::runtime(lang.far_pointer), target_name), 3
+				};
+				s->stats.far_jumps++;
+				break;
+			}
+		}
+		s->measure();
+	}
+	err::check();
+}
+
+// Jumps with a short form, whose operand is a displacement from the next
+// instruction rather than an address.
+static const struct {const char * handler; const char * name; const char * short_handler;} short_forms[] = {
+	{"StdGoto",               "goto_rel8",                 "StdGotoRel8"},
+	{"StdGotoConditional",    "goto_conditional_rel8",     "StdGotoConditionalRel8"},
+	{"StdGotoConditionalNot", "goto_conditional_not_rel8", "StdGotoConditionalNotRel8"},
+};
+
+void relax_branches(script& s, environment& env, bool fast) {
+	std::map<string, size_t> labels;
+	for (size_t i = 0; i < s.code.size(); i++) {
+		if (s.code[i].type != instype::LABEL) continue;
+		labels[fmt::format(fmt::runtime(lang.local_label), s.code[i].name)] = i;
+	}
+
+	// Find each jump to a label in this script which has a short form.
+	struct branch {
+		size_t index;
+		size_t target;
+		const char * name;
+		bool fits = true;
+	};
+	std::vector<branch> branches;
+	// Instructions whose size the compiler cannot be sure of, such as macros
+	// and strings, which may use a charmap. Jumps are not shortened across
+	// them.
+	std::vector<bool> unknown(s.code.size());
+	// Jumps to another script may later become far, and one byte larger.
+	std::vector<unsigned> sizes(s.code.size());
+	for (size_t i = 0; i < s.code.size(); i++) {
+		instruction& ins = s.code[i];
+		sizes[i] = ins.size();
+		unknown[i] = ins.type == instype::MACRO;
+		for (auto& op : ins.operands) if (op.type == optype::STRING) unknown[i] = true;
+		definition * def = ins.type == instype::BYTECODE ? env.get_define(ins.opcode) : nullptr;
+		if (!def || ins.operands.empty()) continue;
+		auto target = labels.find(ins.operands.back().value);
+		for (auto& form : far_forms) {
+			if (def->handler == form.handler && target == labels.end()) sizes[i]++;
+		}
+		if (target == labels.end()) continue;
+		for (auto& form : short_forms) {
+			if (def->handler != form.handler) continue;
+			definition * short_def = env.get_define(form.name);
+			if (!short_def || short_def->handler != form.short_handler) break;
+			if (fast && cost::handler(*short_def, env.runtime) > cost::handler(*def, env.runtime)) break;
+			branches.push_back({.index = i, .target = target->second, .name = form.name});
+			sizes[i] -= ins.operands.back().size - 1;
+			break;
+		}
+	}
+	if (branches.empty()) return;
+
+	// Begin with every jump short, and lengthen those which do not reach
+	// until none change. Lengthening a jump only moves others further apart,
+	// so this always finishes.
+	for (bool changed = true; changed;) {
+		changed = false;
+		std::vector<long> offsets = {0};
+		std::vector<unsigned> unknowns = {0};
+		for (size_t i = 0; i < s.code.size(); i++) {
+			offsets.push_back(offsets.back() + sizes[i]);
+			unknowns.push_back(unknowns.back() + unknown[i]);
+		}
+		for (auto& b : branches) {
+			if (!b.fits) continue;
+			long displacement = offsets[b.target] - offsets[b.index + 1];
+			size_t first = std::min(b.index + 1, b.target);
+			size_t last = std::max(b.index + 1, b.target);
+			if (displacement >= -128 && displacement <= 127 && unknowns[last] == unknowns[first]) continue;
+			b.fits = false;
+			sizes[b.index] += s.code[b.index].operands.back().size - 1;
+			changed = true;
+		}
+	}
+
+	for (auto& b : branches) {
+		if (!b.fits) continue;
+		instruction& ins = s.code[b.index];
+		if (ins.name == ins.opcode) ins.name = b.name;
+		ins.opcode = b.name;
+		ins.operands.back() = {
+			optype::VALUE, fmt::format(fmt::runtime(lang.displacement), ins.operands.back().value), 1
+		};
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <set>
+#include <stdio.h>
+#include <string>
+#include "driver.hpp"
+#include "profile.hpp"
+
+// Passes which rewrite a script's compiled code before it is emitted.
+
+// Optimization levels, each of which enables a set of passes. O0 is the
+// default, and compiles scripts as the compiler always has. Os favours smaller
+// scripts and O2 favours fewer dispatches and cycles.
+enum class opt_level { O0, Os, O2 };
+
+// The passes which will run, beginning with those of a level.
+struct pass_manager {
+	std::set<std::string> enabled;
+
+	pass_manager() { set_level(opt_level::O0); }
+	void set_level(opt_level level);
+	// Returns false if there is no pass with this name.
+	bool set(const std::string& name, bool enable);
+	bool runs(const std::string& name) const { return enabled.contains(name); }
+};
+// List every pass, the levels which enable it, and whether it will run.
+void print_passes(FILE * out, const pass_manager& passes);
+
+// Replace instructions with the nibble-packed forms from std_compact when the
+// environment provides them and every operand is below 16. If `fast` is set,
+// forms which the cost model finds slower are left alone.
+void compact_operands(script& s, environment& env, bool fast = false);
+// Merge identical instructions at the end of paths which meet at a label, such
+// as the two branches of an if/else, by jumping into a single copy.
+void merge_tails(script& s, environment& env);
+// Replace jumps to nearby labels with the short forms from std_short when the
+// environment provides them. Jumps which do not reach are left as they are, as
+// are all jumps if `fast` is set and the cost model finds the short form
+// slower.
+void relax_branches(script& s, environment& env, bool fast = false);
+// Run each enabled pass over a compiled script, then update its stats.
+void optimize(script& s, environment& env, const pass_manager& passes);
+// Superinstructions can only be added to an environment with call dispatch and
+// a generated table.
+bool supports_superinstructions(const environment& env);
+// Fuse the most common sequences of instructions across every script into up
+// to `budget` new definitions, each dispatched once. Sequences are ranked by
+// how often they ran in `counts`, if it has any, and then by how often they
+// appear. Only environments with call dispatch and a generated table are
+// changed, and any others are warned about if `warn_unsupported` is set.
+void synthesize_superinstructions(driver& drv, unsigned budget, profile& counts, bool warn_unsupported = true);
+// Move sequences of instructions which are repeated across scripts into shared
+// subroutines in ROM0, reached using call_sub and return_sub, if doing so
+// saves at least `threshold` bytes. The return address is kept in the last
+// two bytes of the pool, so scripts which use them are left alone.
+void outline_subroutines(driver& drv, unsigned threshold);
+// Place ROMX scripts in banks of `bank_size` bytes, numbered from
+// `first_bank`, keeping scripts which jump to each other together. Jumps to a
+// script which may be in another bank are replaced by their far forms. Using
+// `counts`, the scripts which run most often for their size are moved to ROM0
+// until `rom0_bytes` are used, and the rest of the hottest scripts share the
+// first bank.
+void pack_banks(driver& drv, unsigned first_bank, unsigned bank_size, profile& counts, unsigned rom0_bytes = 0);
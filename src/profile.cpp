@@ -0,0 +1,46 @@
+#include <errno.h>
+#include <fmt/format.h>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+#include "exception.hpp"
+#include "profile.hpp"
+
+using std::string;
+
+profile read_profile(const char * path) {
+	std::ifstream file(path);
+	if (!file) err::fatal("Failed to open {}: {}", path, strerror(errno));
+
+	profile result;
+	string line;
+	for (unsigned number = 1; std::getline(file, line); number++) {
+		std::istringstream fields(line);
+		string name, extra;
+		uint64_t count;
+		if (!(fields >> name) || name[0] == '#') continue;
+		if (!(fields >> count) || fields >> extra) {
+			err::error("{}:{}: Expected a script or label name and an execution count", path, number);
+			continue;
+		}
+		// Script names cannot contain a dot, so the first one begins a
+		// label.
+		size_t dot = name.find('.');
+		if (dot == string::npos) {
+			result.scripts[name] += count;
+		} else {
+			result.labels[name.substr(0, dot)][name.substr(dot + 1)] += count;
+		}
+	}
+	err::check();
+	return result;
+}
+
+void write_profile(FILE * out, const profile& counts) {
+	fmt::print(out, "# script executions\n");
+	for (auto& [name, count] : counts.scripts) fmt::print(out, "{} {}\n", name, count);
+	fmt::print(out, "# label executions\n");
+	for (auto& [name, labels] : counts.labels) {
+		for (auto& [label, count] : labels) fmt::print(out, "{}.{} {}\n", name, label, count);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Execution counts measured while running scripts, such as in an emulator or
+// by --emit-profile. Each line of a profile is a name followed by the number of
+// times it was reached. A script's name counts the times it was entered, and
+// `<script>.<label>` counts the times one of its labels was reached, whether
+// by a jump or by falling through. Blank lines and lines beginning with # are
+// ignored.
+struct profile {
+	std::map<std::string, uint64_t> scripts;
+	// The counts of each script's labels, by label name.
+	std::map<std::string, std::map<std::string, uint64_t>> labels;
+	// Decisions which were made differently because of the profile, noted by
+	// the passes which consult it.
+	std::vector<std::string> decisions;
+
+	bool empty() const { return scripts.empty() && labels.empty(); }
+	uint64_t count(const std::string& name) const {
+		auto entry = scripts.find(name);
+		return entry == scripts.end() ? 0 : entry->second;
+	}
+	// Labels which are missing from a profile were not measured, which is not
+	// the same as never being reached.
+	std::optional<uint64_t> label_count(const std::string& script, const std::string& label) const {
+		auto entry = labels.find(script);
+		if (entry == labels.end()) return std::nullopt;
+		auto count = entry->second.find(label);
+		if (count == entry->second.end()) return std::nullopt;
+		return count->second;
+	}
+};
+
+profile read_profile(const char * path);
+void write_profile(FILE * out, const profile& counts);
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <atomic>
+#include <fmt/format.h>
+#include <mutex>
+#include <new>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <vector>
+#include "report.hpp"
+
+using std::string;
+using fmt::format;
+using fmt::print;
+
+namespace report {
+
+static std::atomic<uintmax_t> allocation_count = 0;
+static std::atomic<uintmax_t> allocation_bytes = 0;
+static std::atomic<uintmax_t> free_count = 0;
+
+// A finished phase.
+struct event {
+	string name;
+	string detail;
+	// Microseconds since the first phase began.
+	double start;
+	double duration;
+	unsigned depth;
+	unsigned thread;
+	allocation_counts allocations;
+};
+
+static std::mutex events_lock;
+static std::vector<event> events;
+static const auto epoch = std::chrono::steady_clock::now();
+static thread_local unsigned depth = 0;
+
+// Give each thread a small, stable number for the trace viewer.
+static unsigned thread_number() {
+	static std::atomic<unsigned> next = 0;
+	static thread_local unsigned id = next++;
+	return id;
+}
+
+allocation_counts allocations() {
+	return {allocation_count, allocation_bytes, free_count};
+}
+
+long peak_rss() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage)) return 0;
+	return usage.ru_maxrss;
+}
+
+phase::phase(string name, string detail) :
+	name(std::move(name)),
+	detail(std::move(detail)),
+	start(std::chrono::steady_clock::now()),
+	start_allocations(allocations()),
+	depth(report::depth++) {}
+
+phase::~phase() {
+	auto end = std::chrono::steady_clock::now();
+	allocation_counts end_allocations = allocations();
+	report::depth--;
+
+	event e = {
+		.name = std::move(name),
+		.detail = std::move(detail),
+		.start = std::chrono::duration<double, std::micro>(start - epoch).count(),
+		.duration = std::chrono::duration<double, std::micro>(end - start).count(),
+		.depth = depth,
+		.thread = thread_number(),
+		.allocations = {
+			end_allocations.count - start_allocations.count,
+			end_allocations.bytes - start_allocations.bytes,
+			end_allocations.frees - start_allocations.frees,
+		},
+	};
+	std::lock_guard guard(events_lock);
+	events.push_back(std::move(e));
+}
+
+void print_table(FILE * out) {
+	std::lock_guard guard(events_lock);
+	// Phases are recorded as they end, so sort them back into the order they
+	// began to show nested phases beneath their parents.
+	std::vector<event> sorted = events;
+	std::stable_sort(sorted.begin(), sorted.end(), [](const event& a, const event& b) {
+		if (a.thread != b.thread) return a.thread < b.thread;
+		return a.start < b.start;
+	});
+
+	print(out, "{:<40}", "phase");
+	if (timing) print(out, " {:>12}", "time (ms)");
+	if (memory) print(out, " {:>10} {:>12} {:>10}", "allocs", "bytes", "frees");
+	print(out, "\n");
+
+	for (auto& e : sorted) {
+		string label = string(e.depth * 2, ' ') + e.name;
+		if (e.detail.length()) label += " " + e.detail;
+		print(out, "{:<40}", label);
+		if (timing) print(out, " {:>12.3f}", e.duration / 1000.0);
+		if (memory) {
+			print(
+				out, " {:>10} {:>12} {:>10}",
+				e.allocations.count, e.allocations.bytes, e.allocations.frees
+			);
+		}
+		print(out, "\n");
+	}
+
+	if (memory) {
+		allocation_counts total = allocations();
+		print(
+			out, "total: {} allocations, {} bytes, {} frees\npeak RSS: {} KiB\n",
+			total.count, total.bytes, total.frees, peak_rss()
+		);
+	}
+}
+
+void write_trace(FILE * out) {
+	std::lock_guard guard(events_lock);
+	print(out, "{{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+	for (auto& e : events) {
+		print(
+			out,
+			"\t{{\"name\": {}, \"cat\": \"evscript\", \"ph\": \"X\", "
+			"\"ts\": {:.3f}, \"dur\": {:.3f}, \"pid\": 1, \"tid\": {}, "
+			"\"args\": {{\"detail\": {}, \"allocations\": {}, \"bytes\": {}, \"frees\": {}}}}},\n",
+			json_string(e.name), e.start, e.duration, e.thread,
+			json_string(e.detail), e.allocations.count, e.allocations.bytes, e.allocations.frees
+		);
+	}
+	// Finish with the peak RSS as a counter, which also avoids a trailing comma.
+	double now = std::chrono::duration<double, std::micro>(
+		std::chrono::steady_clock::now() - epoch
+	).count();
+	print(
+		out,
+		"\t{{\"name\": \"peak RSS\", \"ph\": \"C\", \"ts\": {:.3f}, \"pid\": 1, "
+		"\"args\": {{\"KiB\": {}}}}}\n]}}\n",
+		now, peak_rss()
+	);
+}
+
+string json_string(const string& str) {
+	string result = "\"";
+	for (char c : str) {
+		switch (c) {
+		case '"': result += "\\\""; break;
+		case '\\': result += "\\\\"; break;
+		case '\n': result += "\\n"; break;
+		case '\t': result += "\\t"; break;
+		default:
+			if ((unsigned char) c < 0x20) result += format("\\u{:04x}", c);
+			else result += c;
+		}
+	}
+	return result + "\"";
+}
+
+}
+
+// Count every allocation made by the compiler. This is cheap enough to always
+// be enabled, and means phases can be measured without rebuilding.
+void * operator new(size_t size) {
+	report::allocation_count.fetch_add(1, std::memory_order_relaxed);
+	report::allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+	if (void * ptr = malloc(size ? size : 1)) return ptr;
+	throw std::bad_alloc();
+}
+
+void * operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void * ptr) noexcept {
+	if (!ptr) return;
+	report::free_count.fetch_add(1, std::memory_order_relaxed);
+	free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+	operator delete(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept {
+	operator delete(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept {
+	operator delete(ptr);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+// Instrumentation used to find out where the compiler spends its time and
+// memory. Phases are recorded for the whole run, and only printed if requested.
+namespace report {
+
+// Print a table of wall time per phase.
+inline bool timing = false;
+// Print a table of allocations per phase, along with the peak RSS.
+inline bool memory = false;
+// If present, phases are written here in Chrome's trace event format.
+inline FILE * trace_file = nullptr;
+
+// Totals kept by the replacement `operator new` and `operator delete`.
+struct allocation_counts {
+	uintmax_t count = 0;
+	uintmax_t bytes = 0;
+	uintmax_t frees = 0;
+};
+
+allocation_counts allocations();
+// Peak resident set size of the process, in KiB.
+long peak_rss();
+
+// Records the wall time and allocations made while it is in scope.
+// Phases may be nested; the table is indented accordingly.
+struct phase {
+	std::string name;
+	std::string detail;
+	std::chrono::steady_clock::time_point start;
+	allocation_counts start_allocations;
+	unsigned depth;
+
+	phase(std::string name, std::string detail = "");
+	~phase();
+};
+
+void print_table(FILE * out);
+void write_trace(FILE * out);
+
+// Quote and escape a string for use in JSON output.
+std::string json_string(const std::string& str);
+
+}
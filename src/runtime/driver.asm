@@ -1,24 +1,55 @@
+; Read the handler for opcode a from the jump table into bc, clobbering hl.
+MACRO evs_lookup
+IF DEF(EVS_SPLIT_TABLE)
+	; Split tables are page aligned, so the opcode is the low byte of the
+	; address, and the handler's high byte is 256 bytes later.
+	ld l, a
+	ld h, HIGH(EVScriptBytecodeTable)
+	ld c, [hl]
+	inc h
+	ld b, [hl]
+ELSE
+	add a, LOW(EVScriptBytecodeTable >> 1)
+	ld l, a
+	adc a, HIGH(EVScriptBytecodeTable >> 1)
+	sub a, l
+	ld h, a
+	add hl, hl
+	ld a, [hli]
+	ld b, [hl]
+	ld c, a
+ENDC
+ENDM
+
 SECTION "EVScript Driver", ROM0
+IF DEF(EVS_THREADED)
+; Handlers jump back to EVScriptNext rather than returning, and the pool
+; pointer stays in de for the entire script, so nothing is pushed per
+; instruction. Yielding handlers return directly to ExecuteScript's caller.
 ; @param de: Variable pool
 ; @param hl: Script pointer
 ExecuteScript::
 	ld a, h
 	or a, l
 	ret z
-.next
+EVScriptNext::
 	ld a, [hli]
 	push hl
-	add a, LOW(EVScriptBytecodeTable >> 1)
-	ld l, a
-	adc a, HIGH(EVScriptBytecodeTable >> 1)
-	sub a, l
-	ld h, a
-	add hl, hl
+	evs_lookup
+	pop hl
+	push bc
+	ret
+ELSE
+; @param de: Variable pool
+; @param hl: Script pointer
+ExecuteScript::
+	ld a, h
+	or a, l
+	ret z
+.next
 	ld a, [hli]
-	ld h, [hl]
-	ld l, a
-	ld b, h
-	ld c, l
+	push hl
+	evs_lookup
 	pop hl
 	push de
 	call .callBC
@@ -28,6 +59,10 @@ ExecuteScript::
 .callBC
 	push bc
 	ret
+ENDC
 
+; When the compiler generates the table, it provides EVScriptBytecodeTable.
+IF !DEF(EVS_GENERATED_TABLE)
 SECTION "EVScript Bytecode table", ROM0, ALIGN[1]
 EVScriptBytecodeTable:
+ENDC
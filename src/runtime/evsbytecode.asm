@@ -2,6 +2,100 @@ IF !DEF(swap_bank)
 	FAIL "Define the swap_bank macro in runtime.asm"
 ENDC
 
+DEF EVSCRIPT_RUNTIME EQU 1
+
+; Threaded builds and split tables use a jump table generated by the compiler,
+; rather than the std_bytecode macro.
+IF (DEF(EVS_THREADED) || DEF(EVS_SPLIT_TABLE)) && !DEF(EVS_GENERATED_TABLE)
+	DEF EVS_GENERATED_TABLE EQU 1
+ENDC
+
+; Each handler is only assembled if EVS_USE_<handler> is defined. When the
+; compiler's output is included before the runtime, it defines these for the
+; handlers which are used, along with EVS_STRIP_HANDLERS. Otherwise, every
+; handler is assembled.
+MACRO evs_use
+	REPT _NARG
+		IF !DEF(EVS_USE_\1)
+			DEF EVS_USE_\1 EQU 1
+		ENDC
+		SHIFT
+	ENDR
+ENDM
+
+IF !DEF(EVS_STRIP_HANDLERS)
+	evs_use StdReturn, StdYield, StdGotoConditional, StdGotoConditionalNot, \
+		StdGotoConditionalFar, StdGotoConditionalNotFar, StdCallAsm, StdCallAsmFar, \
+		StdAdd, StdSub, StdMul, StdDiv, StdBinaryAnd, StdBinaryOr, StdEqu, StdNot, \
+		StdLessThan, StdGreaterThanEqu, StdLogicalAnd, StdLogicalOr, StdAddConst, \
+		StdSubConst, StdMulConst, StdDivConst, StdBinaryAndConst, StdBinaryOrConst, \
+		StdEquConst, StdNotConst, StdLessThanConst, StdGreaterThanEquConst, StdCopy, \
+		StdLoad, StdStore, StdCopyConst, StdLoadConst, StdStoreConst, StdLoopDec8, \
+		StdJumpTable, StdCallSub, StdReturnSub
+ENDC
+
+; Every handler finishes with evs_next. Normally this returns to
+; ExecuteScript, but threaded builds jump straight to the next instruction.
+MACRO evs_next
+IF DEF(EVS_THREADED)
+	jp EVScriptNext
+ELSE
+	ret
+ENDC
+ENDM
+
+; ExecuteScript restores the pool pointer after each handler, but threaded
+; builds keep it in de for the whole script. Handlers which clobber de must
+; save it using these.
+MACRO evs_save_pool
+IF DEF(EVS_THREADED)
+	push de
+ENDC
+ENDM
+
+MACRO evs_restore_pool
+IF DEF(EVS_THREADED)
+	pop de
+ENDC
+ENDM
+
+; Point a register pair at the variable at offset a in the pool, which is
+; pointed to by de. If EVS_PAGE_POOL is defined, every pool must lie within a
+; single page, so there is no need to carry into the high byte.
+MACRO evs_pool_bc
+	add a, e
+	ld c, a
+IF DEF(EVS_PAGE_POOL)
+	ld b, d
+ELSE
+	adc a, d
+	sub a, c
+	ld b, a
+ENDC
+ENDM
+
+MACRO evs_pool_de
+	add a, e
+	ld e, a
+IF !DEF(EVS_PAGE_POOL)
+	adc a, d
+	sub a, e
+	ld d, a
+ENDC
+ENDM
+
+MACRO evs_pool_hl
+	add a, e
+	ld l, a
+IF DEF(EVS_PAGE_POOL)
+	ld h, d
+ELSE
+	adc a, d
+	sub a, l
+	ld h, a
+ENDC
+ENDM
+
 MACRO std_bytecode
 	; Control
 	dw StdReturn
@@ -45,52 +139,124 @@ MACRO std_bytecode
 	dw StdCopyConst
 	dw StdLoadConst
 	dw StdStoreConst
+	dw StdLoopDec8
+	dw StdJumpTable
+	dw StdCallSub
+	dw StdReturnSub
 ENDM
 
 SECTION "EVScript Return", ROM0
+IF DEF(EVS_USE_StdReturn) || DEF(EVS_USE_StdYield)
 StdReturn:
 	ld hl, 0
 StdYield:
+IF !DEF(EVS_THREADED)
 	pop de ; pop return address
 	pop de ; pop pool pointer
+ENDC
 	ret
+ENDC
 
 SECTION "EVScript Goto", ROM0
 StdGoto:
 	ld a, [hli]
 	ld h, [hl]
 	ld l, a
-	ret
+	evs_next
 
+IF DEF(EVS_USE_StdGotoConditional)
 StdGotoConditional:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [bc]
 	and a, a
 	jr nz, StdGoto
 .fail
 	inc hl
 	inc hl
-	ret
+	evs_next
+ENDC
 
+IF DEF(EVS_USE_StdGotoConditionalNot)
 StdGotoConditionalNot:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [bc]
 	and a, a
 	jr z, StdGoto
 .fail
 	inc hl
 	inc hl
-	ret
+	evs_next
+ENDC
+
+; Decrement a counter, and jump unless it reached zero.
+IF DEF(EVS_USE_StdLoopDec8)
+StdLoopDec8:
+	ld a, [hli]
+	evs_pool_bc
+	ld a, [bc]
+	dec a
+	ld [bc], a
+	jr nz, StdGoto
+.done
+	inc hl
+	inc hl
+	evs_next
+ENDC
+
+; Jump to the target at an index less a minimum, or to the default target if
+; the index is out of range.
+IF DEF(EVS_USE_StdJumpTable)
+StdJumpTable:
+	ld a, [hli]
+	evs_pool_bc
+	ld a, [bc]
+	sub a, [hl] ; minimum
+	inc hl
+	cp a, [hl] ; count
+	inc hl
+	jr nc, StdGoto
+	; Skip the default target, and index the table.
+	inc hl
+	inc hl
+	ld c, a
+	ld b, 0
+	sla c
+	rl b
+	add hl, bc
+	jr StdGoto
+ENDC
+
+; Save the address of the next instruction in a slot in the pool, and jump to
+; a subroutine shared between scripts.
+IF DEF(EVS_USE_StdCallSub)
+StdCallSub:
+	inc hl
+	inc hl
+	ld a, [hld] ; slot
+	evs_pool_bc
+	; The next instruction follows the slot.
+	ld a, l
+	add a, 2
+	ld [bc], a
+	inc bc
+	ld a, h
+	adc a, 0
+	ld [bc], a
+	dec hl
+	jr StdGoto
+ENDC
+
+; Return to the address saved by StdCallSub.
+IF DEF(EVS_USE_StdReturnSub)
+StdReturnSub:
+	ld a, [hl]
+	evs_pool_bc
+	ld h, b
+	ld l, c
+	jr StdGoto
+ENDC
 
 SECTION "EVScript GotoFar", ROM0
 StdGotoFar:
@@ -102,51 +268,54 @@ StdGotoFar:
 	swap_bank
 	ld l, c
 	ld h, b
-	ret
+	evs_next
 
+IF DEF(EVS_USE_StdGotoConditionalFar)
 StdGotoConditionalFar:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [bc]
 	and a, a
 	jr nz, StdGotoFar
 .fail
 	inc hl
 	inc hl
-	ret
+	inc hl
+	evs_next
+ENDC
 
+IF DEF(EVS_USE_StdGotoConditionalNotFar)
 StdGotoConditionalNotFar:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [bc]
 	and a, a
 	jr z, StdGotoFar
 .fail
 	inc hl
 	inc hl
-	ret
+	inc hl
+	evs_next
+ENDC
 
 SECTION "EVScript CallAsm", ROM0
+IF DEF(EVS_USE_StdCallAsm)
 StdCallAsm:
 	push hl
 	ld a, [hli]
 	ld h, [hl]
 	ld l, a
+	evs_save_pool
 	call .hl
+	evs_restore_pool
 	pop hl
-	ret
+	evs_next
 .hl
 	jp hl
+ENDC
 
 SECTION "EVScript CallAsmFar", ROM0
+IF DEF(EVS_USE_StdCallAsmFar)
 StdCallAsmFar:
 	push hl
 	ld a, [hli]
@@ -157,11 +326,14 @@ StdCallAsmFar:
 	swap_bank
 	ld h, b
 	ld l, c
+	evs_save_pool
 	call .hl
+	evs_restore_pool
 	pop hl
-	ret
+	evs_next
 .hl
 	jp hl
+ENDC
 
 SECTION "EVScript 8-bit Operations", ROM0
 ; @param de: pool
@@ -170,11 +342,7 @@ SECTION "EVScript 8-bit Operations", ROM0
 ; @return b: rhs
 ConstantOperandPrologue:
 	ld a, [hli] ; lhs offset
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	; de is preserved & variable is pointed to by bc
 	ld a, [bc]
 	ld b, [hl]
@@ -187,37 +355,34 @@ ConstantOperandPrologue:
 ; @return b: rhs
 OperandPrologue:
 	ld a, [hli] ; lhs offset
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	; de is preserved & variable is pointed to by bc
 	push de
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	pop de
 	ld b, a
 	ld a, [bc]
 	ret
 
+IF DEF(EVS_USE_StdAdd)
 StdAdd:
 	call OperandPrologue
 	add a, b ; Here is the actual operation
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdSub)
 StdSub:
 	call OperandPrologue
 	sub a, b ; Here is the actual operation
 	jr StoreEpilogue
+ENDC
 
 ; This is a VERY simple multiply routine. It is meant to be compact, not
 ; fast. Rewrite if speed is needed.
+IF DEF(EVS_USE_StdMul)
 StdMul:
 	call OperandPrologue
 	ld c, a
@@ -228,9 +393,11 @@ StdMul:
 	jr z, StoreEpilogue
 	add a, c
 	jr :-
+ENDC
 
 ; This is a VERY simple divide routine. It is meant to be compact, not
 ; fast. Rewrite if speed is needed.
+IF DEF(EVS_USE_StdDiv)
 StdDiv:
 	call OperandPrologue
 	ld c, 0
@@ -239,17 +406,23 @@ StdDiv:
 	jr c, StoreEpilogue
 	inc c
 	jr :-
+ENDC
 
+IF DEF(EVS_USE_StdBinaryAnd)
 StdBinaryAnd:
 	call OperandPrologue
 	and a, b
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdBinaryOr)
 StdBinaryOr:
 	call OperandPrologue
 	or a, b
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdEqu)
 StdEqu:
 	call OperandPrologue
 	cp a, b
@@ -257,7 +430,9 @@ StdEqu:
 	jr nz, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdNot)
 StdNot:
 	call OperandPrologue
 	cp a, b
@@ -265,7 +440,9 @@ StdNot:
 	jr z, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdLessThan)
 StdLessThan:
 	call OperandPrologue
 	cp a, b
@@ -273,7 +450,9 @@ StdLessThan:
 	jr nc, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdGreaterThanEqu)
 StdGreaterThanEqu:
 	call OperandPrologue
 	cp a, b
@@ -281,7 +460,9 @@ StdGreaterThanEqu:
 	jr c, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdLogicalAnd)
 StdLogicalAnd:
 	call OperandPrologue
 	and a, a
@@ -291,7 +472,9 @@ StdLogicalAnd:
 	jr z, StoreEpilogue
 	ld a, 1
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdLogicalOr)
 StdLogicalOr:
 	call OperandPrologue
 	and a, a
@@ -302,32 +485,36 @@ StdLogicalOr:
 .true
 	ld a, 1
 	; fallthrough
+ENDC
 ; This is stored in the middle so both variable and constant operations can
 ; reach it.
 StoreEpilogue:
+	evs_save_pool
 	ld b, a
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, b
 	ld [de], a
-	ret
+	evs_restore_pool
+	evs_next
 
+IF DEF(EVS_USE_StdAddConst)
 StdAddConst:
 	call ConstantOperandPrologue
 	add a, b ; Here is the actual operation
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdSubConst)
 StdSubConst:
 	call ConstantOperandPrologue
 	sub a, b ; Here is the actual operation
 	jr StoreEpilogue
+ENDC
 
 ; This is a VERY simple multiply routine. It is meant to be compact, not
 ; fast. Rewrite if speed is needed.
+IF DEF(EVS_USE_StdMulConst)
 StdMulConst:
 	call ConstantOperandPrologue
 	ld c, a
@@ -338,9 +525,11 @@ StdMulConst:
 	jr z, StoreEpilogue
 	add a, c
 	jr :-
+ENDC
 
 ; This is a VERY simple divide routine. It is meant to be compact, not
 ; fast. Rewrite if speed is needed.
+IF DEF(EVS_USE_StdDivConst)
 StdDivConst:
 	call ConstantOperandPrologue
 	ld c, 0
@@ -349,17 +538,23 @@ StdDivConst:
 	jr c, StoreEpilogue
 	inc c
 	jr :-
+ENDC
 
+IF DEF(EVS_USE_StdBinaryAndConst)
 StdBinaryAndConst:
 	call ConstantOperandPrologue
 	and a, b ; Here is the actual operation
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdBinaryOrConst)
 StdBinaryOrConst:
 	call ConstantOperandPrologue
 	or a, b ; Here is the actual operation
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdEquConst)
 StdEquConst:
 	call ConstantOperandPrologue
 	cp a, b
@@ -367,7 +562,9 @@ StdEquConst:
 	jr nz, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdNotConst)
 StdNotConst:
 	call ConstantOperandPrologue
 	cp a, b
@@ -375,7 +572,9 @@ StdNotConst:
 	jr z, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdLessThanConst)
 StdLessThanConst:
 	call ConstantOperandPrologue
 	cp a, b
@@ -383,7 +582,9 @@ StdLessThanConst:
 	jr nc, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
+IF DEF(EVS_USE_StdGreaterThanEquConst)
 StdGreaterThanEquConst:
 	call ConstantOperandPrologue
 	cp a, b
@@ -391,59 +592,45 @@ StdGreaterThanEquConst:
 	jr c, StoreEpilogue
 	inc a
 	jr StoreEpilogue
+ENDC
 
 SECTION "EVScript Copy", ROM0
+IF DEF(EVS_USE_StdCopy)
 StdCopy:
 	push de
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	ld [bc], a
 	pop de
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript Load", ROM0
+IF DEF(EVS_USE_StdLoad)
 StdLoad:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
 	push hl
-	add a, e
-	ld l, a
-	adc a, d
-	sub a, l
-	ld h, a
+	evs_pool_hl
 	ld a, [hli]
 	ld h, [hl]
 	ld l, a
 	ld a, [hl]
 	ld [bc], a
 	pop hl
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript Store", ROM0
+IF DEF(EVS_USE_StdStore)
 StdStore:
 	push de
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [bc]
 	inc bc
 	ld d, a
@@ -451,36 +638,28 @@ StdStore:
 	ld b, a
 	ld c, d
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	ld [bc], a
 	pop de
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript CopyConst", ROM0
+IF DEF(EVS_USE_StdCopyConst)
 StdCopyConst:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
 	ld [bc], a
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript LoadConst", ROM0
+IF DEF(EVS_USE_StdLoadConst)
 StdLoadConst:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
 	push hl
 	ld h, [hl]
@@ -489,20 +668,21 @@ StdLoadConst:
 	ld [bc], a
 	pop hl
 	inc hl
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript StoreConst", ROM0
+IF DEF(EVS_USE_StdStoreConst)
 StdStoreConst:
+	evs_save_pool
 	ld a, [hli]
 	ld c, a
 	ld a, [hli]
 	ld b, a
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	ld [bc], a
-	ret
+	evs_restore_pool
+	evs_next
+ENDC
@@ -1,3 +1,15 @@
+IF !DEF(EVSCRIPT_RUNTIME)
+	FAIL "Include evsbytecode.asm before evsbytecode16.asm"
+ENDC
+
+IF !DEF(EVS_STRIP_HANDLERS)
+	evs_use StdAdd16, StdSub16, StdMul16, StdDiv16, StdEqu16, StdNot16, \
+		StdLogicalAnd16, StdLogicalOr16, StdAddConst16, StdSubConst16, \
+		StdMulConst16, StdDivConst16, StdEquConst16, StdNotConst16, StdCopy16, \
+		StdLoad16, StdStore16, StdCopyConst16, StdLoadConst16, StdStoreConst16, \
+		StdLoopDec16
+ENDC
+
 MACRO std_bytecode16
 	; 16-bit ops
 	dw StdAdd16
@@ -22,6 +34,8 @@ MACRO std_bytecode16
 	dw StdCopyConst16
 	dw StdLoadConst16
 	dw StdStoreConst16
+	; Loops
+	dw StdLoopDec16
 	; 16-bit casts
 	dw StdCast8to16
 	dw StdCast16to8
@@ -35,11 +49,7 @@ SECTION "EVScript 16-bit operation", ROM0
 ConstantOperandPrologue16:
 	push de
 	ld a, [hli] ; lhs offset
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	; de is preserved & variable is pointed to by de
 	ld a, [hli]
 	ld h, [hl]
@@ -59,19 +69,11 @@ ConstantOperandPrologue16:
 ; @return bc: rhs
 OperandPrologue16:
 	ld a, [hli] ; lhs offset
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	; de is preserved & variable is pointed to by bc
 	push de
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [bc]
 	ld l, a
 	inc bc
@@ -85,6 +87,7 @@ OperandPrologue16:
 	pop de
 	ret
 
+IF DEF(EVS_USE_StdAdd16)
 StdAdd16:
 	push hl
 	call OperandPrologue16
@@ -92,7 +95,9 @@ StdAdd16:
 	ld b, h
 	ld c, l
 	jp StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdSub16)
 StdSub16:
 	push hl
 	call OperandPrologue16
@@ -108,7 +113,9 @@ StdSub16:
 	ld b, h
 	ld c, l
 	jp StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdMul16)
 StdMul16:
 	push hl
 	call OperandPrologue16
@@ -131,7 +138,9 @@ StdMul16:
 	ld b, h
 	ld c, l
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdDiv16)
 StdDiv16:
 	push hl
 	call OperandPrologue16
@@ -157,7 +166,9 @@ StdDiv16:
 	ld c, e
 	pop de
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdEqu16)
 StdEqu16:
 	push hl
 	call OperandPrologue16
@@ -173,7 +184,9 @@ StdEqu16:
 .fail
 	ld bc, 0
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdNot16)
 StdNot16:
 	push hl
 	call OperandPrologue16
@@ -189,7 +202,9 @@ StdNot16:
 .true
 	ld bc, 1
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdLogicalAnd16)
 StdLogicalAnd16:
 	push hl
 	call OperandPrologue16
@@ -205,7 +220,9 @@ StdLogicalAnd16:
 .fail
 	ld bc, 0
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdLogicalOr16)
 StdLogicalOr16:
 	push hl
 	call OperandPrologue16
@@ -221,21 +238,21 @@ StdLogicalOr16:
 .true
 	ld bc, 1
 	; Fallthrough
+ENDC
 StoreEpilogue16:
 	pop hl
+	evs_save_pool
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, c
 	ld [de], a
 	inc de
 	ld a, b
 	ld [de], a
-	ret
+	evs_restore_pool
+	evs_next
 
+IF DEF(EVS_USE_StdAddConst16)
 StdAddConst16:
 	push hl
 	call ConstantOperandPrologue16
@@ -244,7 +261,9 @@ StdAddConst16:
 	ld c, l
 	pop hl
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdSubConst16)
 StdSubConst16:
 	push hl
 	call ConstantOperandPrologue16
@@ -261,7 +280,9 @@ StdSubConst16:
 	ld c, l
 	pop hl
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdMulConst16)
 StdMulConst16:
 	push hl
 	call ConstantOperandPrologue16
@@ -285,7 +306,9 @@ StdMulConst16:
 	ld c, l
 	pop hl
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdDivConst16)
 StdDivConst16:
 	push hl
 	call ConstantOperandPrologue16
@@ -312,7 +335,9 @@ StdDivConst16:
 	pop de
 	pop hl
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdEquConst16)
 StdEquConst16:
 	push hl
 	call ConstantOperandPrologue16
@@ -330,7 +355,9 @@ StdEquConst16:
 	ld bc, 0
 	pop hl
 	jr StoreEpilogue16
+ENDC
 
+IF DEF(EVS_USE_StdNotConst16)
 StdNotConst16:
 	push hl
 	call ConstantOperandPrologue16
@@ -348,44 +375,34 @@ StdNotConst16:
 	ld bc, 1
 	pop hl
 	jp StoreEpilogue16
+ENDC
 
 SECTION "EVScript Copy16", ROM0
+IF DEF(EVS_USE_StdCopy16)
 StdCopy16:
+	evs_save_pool
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	ld [bc], a
 	inc de
 	inc bc
 	ld a, [de]
 	ld [bc], a
-	ret
+	evs_restore_pool
+	evs_next
+ENDC
 
 SECTION "EVScript Load16", ROM0
+IF DEF(EVS_USE_StdLoad16)
 StdLoad16:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
 	push hl
-	add a, e
-	ld l, a
-	adc a, d
-	sub a, l
-	ld h, a
+	evs_pool_hl
 	ld a, [hli]
 	ld h, [hl]
 	ld l, a
@@ -395,16 +412,15 @@ StdLoad16:
 	ld a, [hl]
 	ld [bc], a
 	pop hl
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript Store16", ROM0
+IF DEF(EVS_USE_StdStore16)
 StdStore16:
+	evs_save_pool
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [bc]
 	inc bc
 	ld d, a
@@ -412,42 +428,35 @@ StdStore16:
 	ld b, a
 	ld c, d
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	ld [bc], a
 	inc de
 	inc bc
 	ld a, [de]
 	ld [bc], a
-	ret
+	evs_restore_pool
+	evs_next
+ENDC
 
 SECTION "EVScript CopyConst16", ROM0
+IF DEF(EVS_USE_StdCopyConst16)
 StdCopyConst16:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
 	ld [bc], a
 	inc bc
 	ld a, [hli]
 	ld [bc], a
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript LoadConst16", ROM0
+IF DEF(EVS_USE_StdLoadConst16)
 StdLoadConst16:
 	ld a, [hli]
-	add a, e
-	ld c, a
-	adc a, d
-	sub a, c
-	ld b, a
+	evs_pool_bc
 	ld a, [hli]
 	push hl
 	ld h, [hl]
@@ -459,10 +468,13 @@ StdLoadConst16:
 	ld [bc], a
 	pop hl
 	inc hl
-	ret
+	evs_next
+ENDC
 
 SECTION "EVScript StoreConst16", ROM0
+IF DEF(EVS_USE_StdStoreConst16)
 StdStoreConst16:
+	evs_save_pool
 	ld a, [hli]
 	ld c, a
 	ld a, [hli]
@@ -476,15 +488,42 @@ StdStoreConst16:
 	ld c, e
 	pop de
 	ld a, [hli]
-	add a, e
-	ld e, a
-	adc a, d
-	sub a, e
-	ld d, a
+	evs_pool_de
 	ld a, [de]
 	ld [bc], a
 	inc de
 	inc bc
 	ld a, [de]
 	ld [bc], a
-	ret
+	evs_restore_pool
+	evs_next
+ENDC
+
+SECTION "EVScript LoopDec16", ROM0
+; Decrement a 16-bit counter, and jump unless it reached zero.
+IF DEF(EVS_USE_StdLoopDec16)
+StdLoopDec16:
+	ld a, [hli]
+	evs_pool_bc
+	ld a, [bc]
+	sub a, 1
+	ld [bc], a
+	inc bc
+	jr c, .borrow
+	; Without a borrow, the counter is only zero if both bytes are.
+	and a, a
+	jp nz, StdGoto
+	ld a, [bc]
+	and a, a
+	jp nz, StdGoto
+	inc hl
+	inc hl
+	evs_next
+
+.borrow
+	; The low byte is now $FF, so the counter cannot be zero.
+	ld a, [bc]
+	dec a
+	ld [bc], a
+	jp StdGoto
+ENDC
@@ -0,0 +1,91 @@
+IF !DEF(EVSCRIPT_RUNTIME)
+	FAIL "Include evsbytecode.asm before evsbytecodecompact.asm"
+ENDC
+
+IF !DEF(EVS_STRIP_HANDLERS)
+	evs_use StdCopyQ, StdCopyConstQ, StdCopyConst16Q, StdAddConstQ, StdSubConstQ
+ENDC
+
+; The compact bytecode has a single operand byte, with a pool index in its high
+; nibble and either a second index or a constant in its low nibble.
+MACRO std_compact_bytecode
+	dw StdCopyQ
+	dw StdCopyConstQ
+	dw StdCopyConst16Q
+	dw StdAddConstQ
+	dw StdSubConstQ
+ENDM
+
+; Point bc at the variable in the high nibble of the operand, without
+; advancing hl.
+MACRO evs_compact_bc
+	ld a, [hl]
+	swap a
+	and a, $0F
+	evs_pool_bc
+ENDM
+
+SECTION "EVScript CopyQ", ROM0
+IF DEF(EVS_USE_StdCopyQ)
+StdCopyQ:
+	evs_save_pool
+	evs_compact_bc
+	ld a, [hli]
+	and a, $0F
+	evs_pool_de
+	ld a, [de]
+	ld [bc], a
+	evs_restore_pool
+	evs_next
+ENDC
+
+SECTION "EVScript CopyConstQ", ROM0
+IF DEF(EVS_USE_StdCopyConstQ)
+StdCopyConstQ:
+	evs_compact_bc
+	ld a, [hli]
+	and a, $0F
+	ld [bc], a
+	evs_next
+ENDC
+
+IF DEF(EVS_USE_StdCopyConst16Q)
+StdCopyConst16Q:
+	evs_compact_bc
+	ld a, [hli]
+	and a, $0F
+	ld [bc], a
+	inc bc
+	xor a, a
+	ld [bc], a
+	evs_next
+ENDC
+
+SECTION "EVScript AddConstQ", ROM0
+IF DEF(EVS_USE_StdAddConstQ)
+StdAddConstQ:
+	evs_save_pool
+	evs_compact_bc
+	ld a, [hli]
+	and a, $0F
+	ld d, a
+	ld a, [bc]
+	add a, d
+	ld [bc], a
+	evs_restore_pool
+	evs_next
+ENDC
+
+IF DEF(EVS_USE_StdSubConstQ)
+StdSubConstQ:
+	evs_save_pool
+	evs_compact_bc
+	ld a, [hli]
+	and a, $0F
+	ld d, a
+	ld a, [bc]
+	sub a, d
+	ld [bc], a
+	evs_restore_pool
+	evs_next
+ENDC
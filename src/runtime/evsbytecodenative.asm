@@ -0,0 +1,17 @@
+IF !DEF(EVSCRIPT_RUNTIME)
+	FAIL "Include evsbytecode.asm before evsbytecodenative.asm"
+ENDC
+
+; Native scripts begin with exec_native, which jumps to their SM83 code. The
+; code runs as a handler would, with the pool in de, and uses exec_native
+; again to resume after a yield or after running bytecode.
+MACRO std_native_bytecode
+	dw StdExecNative
+ENDM
+
+SECTION "EVScript ExecNative", ROM0
+StdExecNative:
+	ld a, [hli]
+	ld h, [hl]
+	ld l, a
+	jp hl
@@ -0,0 +1,50 @@
+IF !DEF(EVSCRIPT_RUNTIME)
+	FAIL "Include evsbytecode.asm before evsbytecodeshort.asm"
+ENDC
+
+IF !DEF(EVS_STRIP_HANDLERS)
+	evs_use StdGotoConditionalRel8, StdGotoConditionalNotRel8
+ENDC
+
+; Short jumps have a signed operand, which is added to the address of the
+; next instruction.
+MACRO std_short_bytecode
+	dw StdGotoRel8
+	dw StdGotoConditionalRel8
+	dw StdGotoConditionalNotRel8
+ENDM
+
+SECTION "EVScript GotoRel8", ROM0
+StdGotoRel8:
+	ld a, [hli]
+	; Sign-extend the displacement into bc.
+	ld c, a
+	add a, a
+	sbc a, a
+	ld b, a
+	add hl, bc
+	evs_next
+
+IF DEF(EVS_USE_StdGotoConditionalRel8)
+StdGotoConditionalRel8:
+	ld a, [hli]
+	evs_pool_bc
+	ld a, [bc]
+	and a, a
+	jr nz, StdGotoRel8
+.fail
+	inc hl
+	evs_next
+ENDC
+
+IF DEF(EVS_USE_StdGotoConditionalNotRel8)
+StdGotoConditionalNotRel8:
+	ld a, [hli]
+	evs_pool_bc
+	ld a, [bc]
+	and a, a
+	jr z, StdGotoRel8
+.fail
+	inc hl
+	evs_next
+ENDC
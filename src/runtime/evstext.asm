@@ -0,0 +1,87 @@
+; Decoder for text compressed by `--compress-text`. Each byte below $80 is a
+; character, and each byte from $80 is a pair of symbols from
+; EVScriptTextDictionary, which may themselves be pairs. Characters are
+; returned one at a time, so a text box can print them as they arrive.
+;
+; The compiler's output defines EVS_TEXT_DEPTH, the number of pairs which may
+; be pending at once, if it is included before this file.
+IF !DEF(EVS_TEXT_DEPTH)
+	DEF EVS_TEXT_DEPTH EQU 16
+ENDC
+
+SECTION "EVScript Text Decoder State", WRAM0
+wEVSTextPointer: ds 2
+wEVSTextPending: ds 1
+; The right-hand side of each pair whose left-hand side is being expanded.
+wEVSTextStack: ds EVS_TEXT_DEPTH
+
+SECTION "EVScript Text Decoder", ROM0
+; Begin decoding a string.
+; @param hl: String
+EVScriptTextStart::
+	ld a, l
+	ld [wEVSTextPointer], a
+	ld a, h
+	ld [wEVSTextPointer + 1], a
+	xor a, a
+	ld [wEVSTextPending], a
+	ret
+
+; Decode the next character of the string. The terminator is returned each
+; time once the string has ended.
+; @return a: Character, or 0 at the end of the string
+; @clobbers: bc, hl
+EVScriptTextNext::
+	ld a, [wEVSTextPending]
+	and a, a
+	jr z, .read
+	; Continue with the most recent right-hand side.
+	dec a
+	ld [wEVSTextPending], a
+	add a, LOW(wEVSTextStack)
+	ld l, a
+	adc a, HIGH(wEVSTextStack)
+	sub a, l
+	ld h, a
+	ld a, [hl]
+	jr .expand
+
+.read
+	ld hl, wEVSTextPointer
+	ld a, [hli]
+	ld h, [hl]
+	ld l, a
+	ld a, [hli]
+	and a, a
+	ret z
+	ld c, a
+	ld a, l
+	ld [wEVSTextPointer], a
+	ld a, h
+	ld [wEVSTextPointer + 1], a
+	ld a, c
+.expand
+	bit 7, a
+	ret z
+	; Look up the pair. Doubling the byte discards its high bit.
+	add a, a
+	add a, LOW(EVScriptTextDictionary)
+	ld l, a
+	adc a, HIGH(EVScriptTextDictionary)
+	sub a, l
+	ld h, a
+	ld a, [hli]
+	ld b, a
+	ld c, [hl]
+	; Save the right-hand side, and expand the left.
+	ld a, [wEVSTextPending]
+	add a, LOW(wEVSTextStack)
+	ld l, a
+	adc a, HIGH(wEVSTextStack)
+	sub a, l
+	ld h, a
+	ld [hl], c
+	ld hl, wEVSTextPending
+	inc [hl]
+	ld a, b
+	jr .expand
@@ -0,0 +1,171 @@
+#include <fmt/format.h>
+#include "cost.hpp"
+#include "report.hpp"
+#include "stats.hpp"
+
+using std::string;
+using fmt::print;
+using report::json_string;
+
+// Combine the statistics of several scripts.
+static void accumulate(script_stats& total, const script_stats& stats) {
+	total.bytecode_bytes += stats.bytecode_bytes;
+	total.string_bytes += stats.string_bytes;
+	for (auto& [name, count] : stats.opcodes) total.opcodes[name] += count;
+	for (auto& [line, size] : stats.lines) total.lines[line] += size;
+	if (stats.peak_pool > total.peak_pool) total.peak_pool = stats.peak_pool;
+	total.temporaries += stats.temporaries;
+	total.labels += stats.labels;
+	total.rotated_loops += stats.rotated_loops;
+	total.merged_bytes += stats.merged_bytes;
+	total.far_jumps += stats.far_jumps;
+	total.macros += stats.macros;
+}
+
+static void print_json_map(FILE * out, const std::map<string, unsigned>& map, const char * indent) {
+	print(out, "{{");
+	const char * separator = "";
+	for (auto& [key, value] : map) {
+		print(out, "{}\n{}\t\t{}: {}", separator, indent, json_string(key), value);
+		separator = ",";
+	}
+	print(out, "{}}}", map.size() ? fmt::format("\n{}\t", indent) : "");
+}
+
+static void print_json(FILE * out, const script_stats& stats, const char * indent) {
+	print(out, "{{\n");
+	print(out, "{}\t\"bytecode_bytes\": {},\n", indent, stats.bytecode_bytes);
+	print(out, "{}\t\"string_bytes\": {},\n", indent, stats.string_bytes);
+	print(out, "{}\t\"total_bytes\": {},\n", indent, stats.bytecode_bytes + stats.string_bytes);
+	print(out, "{}\t\"peak_pool\": {},\n", indent, stats.peak_pool);
+	print(out, "{}\t\"temporaries\": {},\n", indent, stats.temporaries);
+	print(out, "{}\t\"labels\": {},\n", indent, stats.labels);
+	print(out, "{}\t\"rotated_loops\": {},\n", indent, stats.rotated_loops);
+	print(out, "{}\t\"merged_bytes\": {},\n", indent, stats.merged_bytes);
+	print(out, "{}\t\"far_jumps\": {},\n", indent, stats.far_jumps);
+	print(out, "{}\t\"macros\": {},\n", indent, stats.macros);
+	print(out, "{}\t\"opcodes\": ", indent);
+	print_json_map(out, stats.opcodes, indent);
+	print(out, ",\n{}\t\"lines\": ", indent);
+	print_json_map(out, stats.lines, indent);
+	print(out, "\n{}}}", indent);
+}
+
+static void print_text(FILE * out, const string& name, const script_stats& stats) {
+	print(
+		out, "{}: {} bytes ({} bytecode, {} strings), pool {}, {} temporaries, {} labels",
+		name, stats.bytecode_bytes + stats.string_bytes, stats.bytecode_bytes,
+		stats.string_bytes, stats.peak_pool, stats.temporaries, stats.labels
+	);
+	if (stats.macros) print(out, ", {} macros of unknown size", stats.macros);
+	if (stats.rotated_loops) {
+		print(
+			out, ", {} rotated loop{} saving a dispatch per iteration",
+			stats.rotated_loops, stats.rotated_loops == 1 ? "" : "s"
+		);
+	}
+	if (stats.merged_bytes) print(out, ", {} bytes saved by merging branch tails", stats.merged_bytes);
+	if (stats.far_jumps) print(out, ", {} far jump{}", stats.far_jumps, stats.far_jumps == 1 ? "" : "s");
+	print(out, "\n");
+	for (auto& [opcode, count] : stats.opcodes) {
+		print(out, "\t{:<24} {}\n", opcode, count);
+	}
+}
+
+// Estimate the cost of each opcode used, under each dispatch mode.
+static std::map<string, cost::opcode_cost> opcode_costs(driver& drv) {
+	std::map<string, cost::opcode_cost> costs;
+	for (auto& [name, script] : drv.scripts) {
+		environment& env = drv.environments[script.env];
+		for (auto& [opcode, count] : script.stats.opcodes) {
+			if (definition * def = env.get_define(opcode)) {
+				costs.emplace(opcode, cost::estimate(*def, env.runtime));
+			}
+		}
+	}
+	return costs;
+}
+
+// The dispatch cost of each combination of dispatch type and table layout.
+static unsigned dispatch_cost(dispatch_type dispatch, table_layout layout) {
+	return cost::dispatch({.dispatch = dispatch, .layout = layout});
+}
+
+void print_stats(FILE * out, driver& drv, stats_format format, const string_pool& strings) {
+	// Sort scripts by name so that output can be compared between builds.
+	std::map<string, script *> scripts;
+	for (auto& [name, script] : drv.scripts) scripts[name] = &script;
+
+	script_stats total;
+	for (auto& [name, script] : scripts) accumulate(total, script->stats);
+	std::map<string, cost::opcode_cost> costs = opcode_costs(drv);
+
+	if (format == stats_format::JSON) {
+		print(out, "{{\n\t\"scripts\": {{");
+		const char * separator = "";
+		for (auto& [name, script] : scripts) {
+			print(out, "{}\n\t\t{}: ", separator, json_string(name));
+			print_json(out, script->stats, "\t\t");
+			separator = ",";
+		}
+		print(out, "\n\t}},\n\t\"summary\": ");
+		print_json(out, total, "\t");
+		print(out, ",\n\t\"script_count\": {},\n", drv.scripts.size());
+		if (!strings.empty()) {
+			print(
+				out,
+				"\t\"string_pool\": {{\"references\": {}, \"unique\": {}, \"emitted\": {}, "
+				"\"dictionary\": {}, \"bytes\": {}, \"saved\": {}}},\n",
+				strings.references, strings.unique, strings.strings.size(),
+				strings.dictionary.size(), strings.bytes, strings.unpooled_bytes - strings.bytes
+			);
+		}
+		print(
+			out,
+			"\t\"dispatch\": {{\n\t\t\"call\": {},\n\t\t\"threaded\": {},\n"
+			"\t\t\"call_split\": {},\n\t\t\"threaded_split\": {},\n\t\t\"opcodes\": {{",
+			dispatch_cost(dispatch_type::CALL, table_layout::INTERLEAVED),
+			dispatch_cost(dispatch_type::THREADED, table_layout::INTERLEAVED),
+			dispatch_cost(dispatch_type::CALL, table_layout::SPLIT),
+			dispatch_cost(dispatch_type::THREADED, table_layout::SPLIT)
+		);
+		separator = "";
+		for (auto& [opcode, c] : costs) {
+			print(
+				out, "{}\n\t\t\t{}: {{\"call\": {}, \"threaded\": {}, \"saved\": {}}}",
+				separator, json_string(opcode), c.call, c.threaded, c.saved()
+			);
+			separator = ",";
+		}
+		print(out, "{}}}\n\t}}\n}}\n", costs.size() ? "\n\t\t" : "");
+	} else {
+		for (auto& [name, script] : scripts) print_text(out, name, script->stats);
+		print_text(out, fmt::format("total ({} scripts)", drv.scripts.size()), total);
+		if (!strings.empty()) {
+			print(
+				out, "string pool: {} bytes for {} references to {} unique strings, {} emitted, saving {} bytes\n",
+				strings.bytes, strings.references, strings.unique, strings.strings.size(),
+				strings.unpooled_bytes - strings.bytes
+			);
+			if (strings.compressed()) {
+				print(out, "\tcompressed using {} pairs\n", strings.dictionary.size());
+			}
+		}
+		print(
+			out, "dispatch cost in M-cycles: call {}, threaded {} ({} and {} with a split table)\n",
+			dispatch_cost(dispatch_type::CALL, table_layout::INTERLEAVED),
+			dispatch_cost(dispatch_type::THREADED, table_layout::INTERLEAVED),
+			dispatch_cost(dispatch_type::CALL, table_layout::SPLIT),
+			dispatch_cost(dispatch_type::THREADED, table_layout::SPLIT)
+		);
+		for (auto& [opcode, c] : costs) {
+			print(out, "\t{:<24} {:>4} -> {:<4} (saves {})\n", opcode, c.call, c.threaded, c.saved());
+		}
+	}
+}
+
+void print_size_profile(FILE * out, driver& drv) {
+	std::map<string, unsigned> stacks;
+	for (auto& [name, script] : drv.scripts) script.profile(stacks, name);
+	for (auto& [stack, size] : stacks) print(out, "{} {}\n", stack, size);
+}
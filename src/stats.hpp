@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdio.h>
+#include "driver.hpp"
+#include "strings.hpp"
+
+enum class stats_format { NONE, TEXT, JSON };
+
+// Print the size and opcode statistics of every compiled script, followed by a
+// summary of the whole project, and the string pool if there is one.
+void print_stats(FILE * out, driver& drv, stats_format format, const string_pool& strings = {});
+
+// Print the number of bytes produced by each statement as collapsed stacks,
+// suitable for generating a flame graph.
+void print_size_profile(FILE * out, driver& drv);
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <fmt/format.h>
+#include <map>
+#include "langs.hpp"
+#include "strings.hpp"
+
+using std::string;
+using fmt::format;
+using fmt::print;
+
+// A section may not be larger than a ROM bank.
+static const unsigned section_limit = 0x4000;
+// Compressed text uses the bytes from $80 for pairs, so characters must be
+// ASCII.
+static const unsigned pair_base = 0x80;
+static const unsigned max_pairs = 0x80;
+
+// Split a string literal into the characters it assembles to, keeping escape
+// sequences together. Like the size stats, this assumes that each character is
+// one byte.
+static std::vector<string> characters(const string& text) {
+	std::vector<string> result;
+	for (size_t i = 0; i < text.length(); i++) {
+		size_t length = text[i] == '\\' && i + 1 < text.length() ? 2 : 1;
+		result.push_back(text.substr(i, length));
+		i += length - 1;
+	}
+	return result;
+}
+
+string string_pool::decode(const std::vector<unsigned>& symbols) const {
+	string result;
+	std::vector<unsigned> pending(symbols.rbegin(), symbols.rend());
+	while (!pending.empty()) {
+		unsigned symbol = pending.back();
+		pending.pop_back();
+		if (symbol < characters.size()) {
+			result += characters[symbol];
+		} else {
+			auto [lhs, rhs] = dictionary[symbol - characters.size()];
+			pending.push_back(rhs);
+			pending.push_back(lhs);
+		}
+	}
+	return result;
+}
+
+// Repeatedly replace the most common pair of symbols with a new symbol (byte
+// pair encoding), until no pair saves more than its dictionary entry costs.
+static void compress_text(string_pool& pool, std::vector<std::vector<unsigned>>& strings) {
+	std::vector<unsigned> depths;
+	while (pool.dictionary.size() < max_pairs) {
+		std::map<std::pair<unsigned, unsigned>, unsigned> counts;
+		for (auto& str : strings) {
+			for (size_t i = 0; i + 1 < str.size(); i++) {
+				counts[{str[i], str[i + 1]}]++;
+				// Only every other pair in a run such as "aaa" can be
+				// replaced.
+				if (str[i] == str[i + 1] && i + 2 < str.size() && str[i + 2] == str[i]) i++;
+			}
+		}
+		std::pair<unsigned, unsigned> best;
+		unsigned best_count = 0;
+		for (auto& [pair, count] : counts) {
+			if (count > best_count) {
+				best = pair;
+				best_count = count;
+			}
+		}
+		// Each entry in the dictionary costs two bytes.
+		if (best_count <= 2) break;
+
+		unsigned symbol = pool.characters.size() + pool.dictionary.size();
+		pool.dictionary.push_back(best);
+		for (auto& str : strings) {
+			std::vector<unsigned> result;
+			for (size_t i = 0; i < str.size(); i++) {
+				if (i + 1 < str.size() && str[i] == best.first && str[i + 1] == best.second) {
+					result.push_back(symbol);
+					i++;
+				} else {
+					result.push_back(str[i]);
+				}
+			}
+			str = result;
+		}
+
+		// The decoder holds the right-hand side of a pair while it expands
+		// the left.
+		auto depth = [&](unsigned symbol) {
+			return symbol < pool.characters.size() ? 0 : depths[symbol - pool.characters.size()];
+		};
+		depths.push_back(std::max(depth(best.first) + 1, depth(best.second)));
+		pool.decoder_depth = std::max(pool.decoder_depth, depths.back());
+	}
+}
+
+string_pool build_string_pool(driver& drv, const string& section, bool compress) {
+	string_pool pool = {.section = section};
+
+	// Sort scripts by name so that the pool is the same between builds.
+	std::map<string, script *> scripts;
+	for (auto& [name, script] : drv.scripts) scripts[name] = &script;
+
+	// Find each unique string, in the order they are first used, and number
+	// each character.
+	std::vector<string> texts;
+	std::vector<std::vector<unsigned>> symbols;
+	std::map<string, size_t> indices;
+	std::map<string, unsigned> character_ids;
+	for (auto& [name, script] : scripts) {
+		for (auto& str : script->strings) {
+			pool.references++;
+			pool.unpooled_bytes += characters(str.text).size() + 1;
+			if (indices.contains(str.text)) continue;
+			indices[str.text] = texts.size();
+			texts.push_back(str.text);
+			std::vector<unsigned> ids;
+			for (auto& c : characters(str.text)) {
+				if (compress && (unsigned char) c[0] >= pair_base) {
+					err::error("Cannot compress \"{}\"; compressed text must be ASCII", str.text);
+				}
+				auto [id, inserted] = character_ids.emplace(c, pool.characters.size());
+				if (inserted) pool.characters.push_back(c);
+				ids.push_back(id->second);
+			}
+			symbols.push_back(ids);
+		}
+	}
+	err::check();
+	pool.unique = texts.size();
+	if (compress) compress_text(pool, symbols);
+
+	// Once sorted by their reversed symbols, a string which ends another is
+	// immediately followed by a string it ends, so each string only needs to
+	// be compared with the next. Working backwards means that the next
+	// string has already found the longest string containing it.
+	struct candidate {
+		std::vector<unsigned> reversed;
+		// The string this one is placed within, and how far into it.
+		size_t host;
+		unsigned offset = 0;
+	};
+	std::vector<candidate> candidates;
+	for (size_t i = 0; i < symbols.size(); i++) {
+		candidates.push_back({.reversed = {symbols[i].rbegin(), symbols[i].rend()}, .host = i});
+	}
+	std::vector<size_t> order(candidates.size());
+	for (size_t i = 0; i < order.size(); i++) order[i] = i;
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return candidates[a].reversed < candidates[b].reversed;
+	});
+	for (size_t i = order.size(); i-- > 1;) {
+		candidate& str = candidates[order[i - 1]];
+		candidate& next = candidates[order[i]];
+		if (
+			str.reversed.size() > next.reversed.size()
+			|| !std::equal(str.reversed.begin(), str.reversed.end(), next.reversed.begin())
+		) continue;
+		str.host = next.host;
+		str.offset = candidates[next.host].reversed.size() - str.reversed.size();
+	}
+
+	// Number the strings which are emitted, and find where every other string
+	// is placed.
+	std::vector<string> labels(candidates.size());
+	for (size_t i = 0; i < candidates.size(); i++) {
+		if (candidates[i].host != i) continue;
+		labels[i] = format("EVScriptString{}", pool.strings.size());
+		pool.strings.push_back(symbols[i]);
+		pool.bytes += symbols[i].size() + 1;
+	}
+	pool.bytes += pool.dictionary.size() * 2;
+
+	// Make sure that every string, including those within another, decodes
+	// to the original text.
+	for (size_t i = 0; i < candidates.size(); i++) {
+		const std::vector<unsigned>& host = symbols[candidates[i].host];
+		string decoded = pool.decode({host.begin() + candidates[i].offset, host.end()});
+		if (decoded != texts[i]) {
+			err::fatal("String \"{}\" was pooled as \"{}\"", texts[i], decoded);
+		}
+	}
+
+	for (auto& [name, script] : scripts) {
+		std::map<string, string> references;
+		for (size_t i = 0; i < script->strings.size(); i++) {
+			candidate& str = candidates[indices[script->strings[i].text]];
+			string label = labels[str.host];
+			if (str.offset) label = format("({} + {})", label, str.offset);
+			references[format(fmt::runtime(lang.local_label), format("string_table{}", i))] = label;
+		}
+		for (auto& ins : script->code) for (auto& op : ins.operands) {
+			if (op.type != optype::VALUE) continue;
+			auto reference = references.find(op.value);
+			if (reference != references.end()) op.value = reference->second;
+		}
+		script->strings.clear();
+		script->measure();
+	}
+	return pool;
+}
+
+// Write a list of symbols as the operands of a byte directive, grouping
+// characters into string literals.
+static string symbol_list(const string_pool& pool, const std::vector<unsigned>& symbols) {
+	string result;
+	bool in_string = false;
+	for (unsigned symbol : symbols) {
+		bool character = symbol < pool.characters.size();
+		if (in_string && !character) result += "\"";
+		if (result.length() && !(in_string && character)) result += ", ";
+		if (character) {
+			if (!in_string) result += "\"";
+			result += pool.characters[symbol];
+		} else {
+			result += format(fmt::runtime(lang.number), pair_base + symbol - pool.characters.size());
+		}
+		in_string = character;
+	}
+	if (in_string) result += "\"";
+	return result;
+}
+
+void print_string_pool(FILE * out, const string_pool& pool) {
+	if (pool.compressed()) {
+		print(out, "\nDEF EVS_TEXT_DEPTH = {}\n", pool.decoder_depth);
+		print(out, "SECTION \"EVScript Text Dictionary\", ROM0\nEVScriptTextDictionary::\n");
+		for (auto [lhs, rhs] : pool.dictionary) {
+			print(out, "\t{} {}\n", lang.byte, symbol_list(pool, {lhs, rhs}));
+		}
+	}
+
+	unsigned section_size = section_limit;
+	unsigned sections = 0;
+	for (size_t i = 0; i < pool.strings.size(); i++) {
+		unsigned size = pool.strings[i].size() + 1;
+		if (section_size + size > section_limit) {
+			print(out, "\nSECTION \"EVScript String Pool {}\", {}\n", sections++, pool.section);
+			section_size = 0;
+		}
+		section_size += size;
+		print(out, "{}\n", format(fmt::runtime(lang.label), format("EVScriptString{}", i)));
+		if (pool.compressed()) {
+			string symbols = symbol_list(pool, pool.strings[i]);
+			print(out, "{} {}{}0\n", lang.byte, symbols, symbols.length() ? ", " : "");
+		} else {
+			print(out, "{}\n", format(fmt::runtime(lang.str), pool.decode(pool.strings[i])));
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "driver.hpp"
+
+// String literals shared by every script, rather than placed after the script
+// which uses them. Identical strings are stored once, and a string which ends
+// another points into it, so "no" is found at the end of "I said no".
+struct string_pool {
+	// The section type the pool is placed in, such as ROM0.
+	std::string section;
+	// Each string which is emitted, labelled EVScriptString{index}, as a list
+	// of symbols. Symbols below `characters.size()` are a character, written
+	// as its text in a string literal. Any others are a pair from the
+	// dictionary, written as $80 plus its index.
+	std::vector<std::vector<unsigned>> strings;
+	std::vector<std::string> characters;
+	// Pairs of symbols which replace common sequences when text is compressed.
+	std::vector<std::pair<unsigned, unsigned>> dictionary;
+	// The number of pairs the decoder may need to hold at once.
+	unsigned decoder_depth = 0;
+	// Number of references to a string, and the number of unique strings.
+	unsigned references = 0;
+	unsigned unique = 0;
+	// Size of the pool including its dictionary, and the size the strings
+	// would have been if each script kept its own copy.
+	unsigned bytes = 0;
+	unsigned unpooled_bytes = 0;
+
+	bool compressed() const { return !dictionary.empty(); }
+	bool empty() const { return strings.empty(); }
+	// Expand a list of symbols back into characters, as the runtime's decoder
+	// does.
+	std::string decode(const std::vector<unsigned>& symbols) const;
+};
+
+// Move the strings of every script into a pool, and point their operands into
+// it. If `compress` is set, common pairs of characters are replaced by a
+// single byte, which runtime/evstext.asm expands.
+string_pool build_string_pool(driver& drv, const std::string& section, bool compress = false);
+void print_string_pool(FILE * out, const string_pool& pool);
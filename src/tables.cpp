@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <fmt/format.h>
+#include <map>
+#include <set>
+#include "tables.hpp"
+
+using std::string;
+using fmt::print;
+
+// Find the environments which scripts are compiled in, sorted by name so that
+// errors are reported consistently.
+static std::map<string, environment *> script_environments(driver& drv) {
+	std::map<string, environment *> environments;
+	for (auto& [name, script] : drv.scripts) {
+		environments[script.env] = &drv.environments[script.env];
+	}
+	return environments;
+}
+
+bytecode_table build_table(driver& drv, opcode_order order) {
+	bytecode_table table;
+	std::map<string, environment *> environments = script_environments(drv);
+	if (environments.empty()) return table;
+
+	// The runtime is only assembled once, so every environment must agree on
+	// how.
+	auto& [first_name, first] = *environments.begin();
+	for (auto& [name, env] : environments) {
+		if (env->runtime != first->runtime) {
+			err::error("Environments {} and {} require different runtime options", first_name, name);
+		}
+	}
+	err::check();
+	if (!first->generates_table()) {
+		if (order != opcode_order::DECLARATION) {
+			err::warn("Opcodes can only be reordered in environments with a generated table");
+		}
+		return table;
+	}
+	table.layout = first->runtime.layout;
+	if (table.layout == table_layout::MANUAL) table.layout = table_layout::INTERLEAVED;
+
+	// Find each opcode used by a script, how often, and where it was first
+	// declared.
+	std::map<string, unsigned> used;
+	for (auto& [name, script] : drv.scripts) {
+		for (auto& ins : script.code) {
+			if ((ins.type == instype::BYTECODE || ins.type == instype::DATA) && ins.opcode.length()) {
+				used[ins.opcode]++;
+			}
+		}
+		// Native scripts are entered using exec_native, which is only
+		// written once they are emitted.
+		if (script.native) used["exec_native"]++;
+	}
+	struct candidate {
+		unsigned bytecode;
+		string name;
+		string handler;
+		unsigned uses;
+		std::vector<string> fused;
+	};
+	std::map<string, candidate> candidates;
+	for (auto& [env_name, env] : environments) {
+		for (auto& [opcode, uses] : used) {
+			definition * def = env->get_define(opcode);
+			if (!def || def->type != DEF) continue;
+			if (def->handler.empty()) {
+				err::error(
+					"{}.{} has no handler for the generated bytecode table. "
+					"Provide one using `def {}(...) = Label;`",
+					env_name, opcode, opcode
+				);
+			}
+			auto [existing, inserted] = candidates.insert(
+				{opcode, {def->bytecode, opcode, def->handler, uses, def->fused}}
+			);
+			if (!inserted && existing->second.handler != def->handler) {
+				err::error(
+					"{} is handled by both {} and {}, but environments must share a table",
+					opcode, existing->second.handler, def->handler
+				);
+			}
+		}
+	}
+
+	// By default, keep opcodes in the order they were declared, so that the
+	// table is stable when scripts change. Ties in frequency fall back on
+	// this too.
+	std::vector<candidate> sorted;
+	for (auto& [name, c] : candidates) sorted.push_back(c);
+	std::stable_sort(sorted.begin(), sorted.end(), [&](const candidate& a, const candidate& b) {
+		if (order == opcode_order::FREQUENCY && a.uses != b.uses) return a.uses > b.uses;
+		return a.bytecode < b.bytecode;
+	});
+	std::map<string, unsigned> numbers;
+	for (auto& c : sorted) {
+		numbers[c.name] = table.entries.size();
+		table.entries.push_back({c.name, c.handler, c.fused});
+	}
+
+	// Split tables are indexed by the opcode alone, so it must fit in a byte.
+	if (table.layout == table_layout::SPLIT && table.entries.size() > 256) {
+		err::error(
+			"Scripts use {} bytecodes, but a split table can only hold 256",
+			table.entries.size()
+		);
+	}
+	err::check();
+
+	for (auto& [env_name, env] : environments) {
+		for (auto& [name, def] : env->defines) {
+			if (def.type != DEF) continue;
+			if (numbers.contains(name)) def.bytecode = numbers[name];
+			else def.stripped = true;
+		}
+	}
+	// Terminators are raw bytes, so renumber them by hand.
+	for (auto& [name, script] : drv.scripts) {
+		for (auto& ins : script.code) {
+			if (ins.type == instype::DATA && numbers.contains(ins.opcode)) {
+				ins.operands[0].value = fmt::format("{}", numbers[ins.opcode]);
+			}
+		}
+	}
+	return table;
+}
+
+void print_table(FILE * out, const bytecode_table& table) {
+	if (table.empty()) return;
+
+	// If this is included before the runtime, it knows not to provide its own
+	// table, and leaves out any handlers which are not used.
+	print(out, "IF !DEF(EVS_GENERATED_TABLE)\n\tDEF EVS_GENERATED_TABLE EQU 1\nENDC\n");
+	print(out, "DEF EVS_STRIP_HANDLERS EQU 1\n");
+	std::set<string> handlers;
+	for (auto& entry : table.entries) {
+		if (entry.fused.empty()) handlers.insert(entry.handler);
+		else handlers.insert(entry.fused.begin(), entry.fused.end());
+	}
+	for (auto& handler : handlers) print(out, "DEF EVS_USE_{} EQU 1\n", handler);
+
+	if (table.layout == table_layout::SPLIT) {
+		print(out, "SECTION \"EVScript Bytecode table\", ROM0, ALIGN[8]\nEVScriptBytecodeTable::\n");
+		for (auto& entry : table.entries) {
+			print(out, "\tdb LOW({}) ; {}\n", entry.handler, entry.name);
+		}
+		if (table.entries.size() < 256) print(out, "\tds {}, 0\n", 256 - table.entries.size());
+		for (auto& entry : table.entries) print(out, "\tdb HIGH({})\n", entry.handler);
+	} else {
+		print(out, "SECTION \"EVScript Bytecode table\", ROM0, ALIGN[1]\nEVScriptBytecodeTable::\n");
+		for (auto& entry : table.entries) {
+			print(out, "\tdw {} ; {}\n", entry.handler, entry.name);
+		}
+	}
+
+	// Superinstructions call each handler in turn, as ExecuteScript would,
+	// then jump to the last so that it returns to ExecuteScript itself.
+	bool fused = false;
+	for (auto& entry : table.entries) {
+		if (entry.fused.empty()) continue;
+		if (!fused) print(out, "SECTION \"EVScript Superinstructions\", ROM0\n");
+		fused = true;
+		print(out, "{}:\n", entry.handler);
+		for (size_t i = 0; i < entry.fused.size() - 1; i++) {
+			print(out, "\tpush de\n\tcall {}\n\tpop de\n", entry.fused[i]);
+		}
+		print(out, "\tjp {}\n", entry.fused.back());
+	}
+}
+
+void print_pools(FILE * out, driver& drv) {
+	for (auto& [name, env] : script_environments(drv)) {
+		if (env->runtime.pool != pool_mode::PAGE) continue;
+		if (env->pool > 256) {
+			err::error("Environment {} has a pool of {} bytes, but page pools can only hold 256", name, env->pool);
+			continue;
+		}
+		if (!env->pool) continue;
+		print(
+			out,
+			"DEF {0}_POOL_SIZE EQU {1}\n"
+			"; Reserve a pool for {0} scripts, which must not cross a page.\n"
+			"MACRO {0}_pool\n"
+			"\tASSERT HIGH(@) == HIGH(@ + {1} - 1), \"{0} pool crosses a page boundary\"\n"
+			"\tds {1}\n"
+			"ENDM\n",
+			name, env->pool
+		);
+	}
+	err::check();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "driver.hpp"
+
+// How to number the bytecode of a generated table. DECLARATION keeps the order
+// of each environment's definitions, while FREQUENCY gives the lowest numbers
+// to the bytecode used most often across every script.
+enum class opcode_order { DECLARATION, FREQUENCY };
+
+// A jump table generated by the compiler, which only contains the bytecode
+// used by scripts, numbered densely.
+struct bytecode_table {
+	struct entry {
+		std::string name;
+		std::string handler;
+		// For superinstructions, the handlers to call in order.
+		std::vector<std::string> fused;
+	};
+
+	table_layout layout = table_layout::MANUAL;
+	std::vector<entry> entries;
+
+	bool empty() const { return layout == table_layout::MANUAL; }
+};
+
+// Check that every environment used by a script agrees on its runtime options,
+// and if they ask for a generated table, renumber their bytecode to match it.
+// Bytecode which is not in the table is marked as stripped.
+bytecode_table build_table(driver& drv, opcode_order order = opcode_order::DECLARATION);
+void print_table(FILE * out, const bytecode_table& table);
+
+// Print a macro to declare the pool of each environment which requires that its
+// pool lies within one page.
+void print_pools(FILE * out, driver& drv);
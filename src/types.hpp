@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+#include <stdio.h>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -8,6 +10,26 @@
 enum deftype { DEF, MAC, ALIAS };
 enum partype { ARG, CON, VARARGS };
 enum class argtype { VAR, NUM, STR, ARG, CON };
+// How the runtime reaches each handler. Anything other than CALL requires a
+// jump table generated by the compiler.
+enum class dispatch_type { CALL, THREADED };
+// MANUAL tables are provided by the user with std_bytecode. Otherwise, the
+// compiler generates the table: INTERLEAVED tables are a list of pointers,
+// while SPLIT tables are page aligned, with the low bytes of each pointer
+// followed by the high bytes 256 bytes later.
+enum class table_layout { MANUAL, INTERLEAVED, SPLIT };
+// PAGE pools never cross a 256-byte boundary, so handlers can index them
+// without carrying into the high byte.
+enum class pool_mode { ANY, PAGE };
+
+// Options which must match how the runtime was assembled.
+struct runtime_options {
+	dispatch_type dispatch = dispatch_type::CALL;
+	table_layout layout = table_layout::MANUAL;
+	pool_mode pool = pool_mode::ANY;
+
+	bool operator==(const runtime_options&) const = default;
+};
 
 // A user-defined type.
 struct type_definition {
@@ -36,6 +58,13 @@ struct definition {
 	std::vector<param> parameters;
 	std::string alias;
 	std::vector<arg> arguments;
+	// The runtime label implementing this bytecode, used in generated tables.
+	std::string handler;
+	// Set if no script uses this bytecode, so it was left out of a generated
+	// table and has no number.
+	bool stripped = false;
+	// For a superinstruction, the handler of each instruction it replaces.
+	std::vector<std::string> fused;
 };
 
 // Describes how to compile a script, such as what functions are available and
@@ -46,6 +75,12 @@ struct environment {
 	int terminator = -1;
 	unsigned pool = 0;
 	unsigned bytecode_count = 0;
+	runtime_options runtime;
+
+	bool generates_table() const {
+		return runtime.dispatch != dispatch_type::CALL
+		    || runtime.layout != table_layout::MANUAL;
+	}
 
 	definition * get_define(std::string name) {
 		if (!defines.contains(name)) return nullptr;
@@ -59,7 +94,22 @@ enum statement_type {
 	CONST_ADD, CONST_SUB, CONST_MULT, CONST_DIV, CONST_BAND, CONST_BOR,
 	COPY, EQU, NOT, LT, LTE, GT, GTE, ADD, SUB, MULT, DIV, BAND, BOR,
 	DECLARE, DROP, DECLARE_ASSIGN, DECLARE_COPY, LABEL, CALL,
-	IF, WHILE, DO, FOR, REPEAT, LOOP, BREAK, CONTINUE, GOTO, CALLASM
+	IF, WHILE, DO, FOR, REPEAT, LOOP, BREAK, CONTINUE, GOTO, CALLASM,
+	LOGICAL_AND, LOGICAL_OR, SWITCH, CASE, EXPRESSION
+};
+
+// An expression with more than one operator, such as `x * 2 + y`. Operations
+// use the statement_type of the equivalent variable operation (EQU to BOR), or
+// LOGICAL_AND and LOGICAL_OR. Leaves are a NOOP holding either a variable or
+// constant name, or a number.
+struct expression_tree {
+	int type = NOOP;
+	std::string identifier;
+	unsigned value = 0;
+	std::vector<expression_tree> operands;
+
+	bool is_leaf() const { return operands.empty(); }
+	bool is_number() const { return is_leaf() && identifier.empty(); }
 };
 
 // The code within a script.
@@ -74,13 +124,17 @@ struct statement {
 	// Arguments passed by the user for a function call.
 	std::vector<arg> args;
 	// A block of sub-statements, for control structures like if and while.
+	// A switch keeps its cases here, and a default as a NOOP.
 	std::vector<statement> statements;
 	// A block of 1 or 3 conditions. if and while use 1 condition, while
-	// a for loop is made up of 3.
+	// a for loop is made up of 3. For && and ||, these are the two operands.
 	std::vector<statement> conditions;
 	// For an if/else statement, an additional block of statements is stored
 	// for the `else`.
 	std::vector<statement> else_statements;
+	// For EXPRESSION statements, the expression to evaluate, as the only
+	// element.
+	std::vector<expression_tree> expression;
 	// For constant operations, this is the constant value of the rhs.
 	// Other statements may repurpose this.
 	unsigned value;
@@ -88,12 +142,100 @@ struct statement {
 	yy::location l;
 };
 
+enum class optype { VALUE, STRING };
+enum class instype { BYTECODE, DATA, LABEL, MACRO };
+
+// A value written as part of an instruction.
+struct operand {
+	optype type;
+	// For values, an expression passed to the assembler. For strings, the
+	// text of a string literal which is written inline.
+	std::string value;
+	// The size of a value in bytes.
+	unsigned size = 0;
+};
+
+// A single unit of compiled output. Scripts are compiled to a list of these so
+// that they can be measured and rewritten before being printed.
+struct instruction {
+	instype type;
+	// The name shown in the output, or the name of a label.
+	std::string name;
+	// The definition which provides the bytecode, or the macro to invoke.
+	// This differs from `name` when a `mac` expands to another definition.
+	// For a terminator, this is the definition whose bytecode it is, if any.
+	std::string opcode;
+	std::vector<operand> operands;
+	// For macros, whether the macro accepts variadic arguments. Each
+	// argument to a variadic macro is followed by a comma.
+	bool variadic = false;
+	// The statement which produced this instruction.
+	yy::location l;
+	// The chain of statements which produced this instruction, outermost
+	// first, as `file:line` separated by semicolons.
+	std::string context;
+
+	// The number of bytes this instruction occupies. Macros are opaque to
+	// the compiler, and are counted as 0.
+	unsigned size() const;
+	void emit(FILE * out, environment& env) const;
+};
+
+// A string literal placed after a script, and the statement which used it.
+struct string_literal {
+	std::string text;
+	yy::location l;
+	std::string context;
+};
+
+// Measurements taken while compiling a script, reported by --stats.
+struct script_stats {
+	unsigned bytecode_bytes = 0;
+	unsigned string_bytes = 0;
+	// Number of times each definition is used.
+	std::map<std::string, unsigned> opcodes;
+	// Bytes produced by each line of source, as `file:line`.
+	std::map<std::string, unsigned> lines;
+	// The highest pool offset used by any variable.
+	unsigned peak_pool = 0;
+	// Internal variables allocated for casts and conditions.
+	unsigned temporaries = 0;
+	unsigned labels = 0;
+	// For loops, which test their condition at the bottom rather than the
+	// top, each saving one dispatch per iteration.
+	unsigned rotated_loops = 0;
+	// Bytes removed by merging identical code at the end of branches.
+	unsigned merged_bytes = 0;
+	// Jumps to a script which may be in another bank.
+	unsigned far_jumps = 0;
+	// Number of macros, whose size is unknown to the compiler.
+	unsigned macros = 0;
+};
+
 // A collection of statements that can be executed.
 struct script {
 	std::string env;
+	// If present, the section type to place the script in, rather than the
+	// environment's.
+	std::string section;
+	// The ROMX bank the script was placed in by --bank-pack, or -1 to let the
+	// linker choose.
+	int bank = -1;
+	// Native scripts are written as SM83 assembly rather than bytecode.
+	bool native = false;
 	std::vector<statement> statements;
+	// The compiled output of the script, and the strings it refers to.
+	std::vector<instruction> code;
+	std::vector<string_literal> strings;
+	script_stats stats;
 	
-	void compile(FILE * out, const std::string& name, environment& env);
+	void compile(const std::string& name, environment& env);
+	// Update stats to reflect the current contents of `code`.
+	void measure();
+	// Add the size of each instruction to `stacks`, keyed by a collapsed
+	// stack of the statements which produced it.
+	void profile(std::map<std::string, unsigned>& stacks, const std::string& name);
+	void emit(FILE * out, const std::string& name, environment& env);
 
 	void initialize() {
 		statements.clear();
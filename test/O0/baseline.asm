@@ -0,0 +1,448 @@
+; Generated by the evscript bytecode compiler, written by Eievui
+DEF baseline_face_BYTECODE = 59
+DEF baseline_band_BYTECODE = 14
+DEF baseline_equ_const_BYTECODE = 28
+DEF baseline_copy16_const_BYTECODE = 17
+DEF baseline_goto_BYTECODE = 2
+DEF baseline_callasm_far_BYTECODE = 9
+DEF baseline_return_BYTECODE = 0
+DEF baseline_goto_far_BYTECODE = 3
+DEF baseline_land_BYTECODE = 20
+DEF baseline_load_const_BYTECODE = 36
+DEF baseline_copy_const_BYTECODE = 35
+DEF baseline_gte_const_BYTECODE = 31
+DEF baseline_sub_BYTECODE = 11
+DEF baseline_land16_BYTECODE = 6
+DEF baseline_load_BYTECODE = 33
+DEF baseline_lt_const_BYTECODE = 30
+DEF baseline_not_const_BYTECODE = 29
+DEF baseline_mul_BYTECODE = 12
+DEF baseline_add_BYTECODE = 10
+DEF baseline_wait_BYTECODE = 58
+DEF baseline_goto_conditional_not_far_BYTECODE = 7
+DEF baseline_store_BYTECODE = 34
+DEF baseline_div_const_BYTECODE = 25
+DEF baseline_copy_BYTECODE = 32
+DEF baseline_goto_conditional_far_BYTECODE = 6
+DEF baseline_yield_BYTECODE = 1
+DEF baseline_mul_const_BYTECODE = 24
+DEF baseline_div_BYTECODE = 13
+DEF baseline_copy16_BYTECODE = 14
+DEF baseline_equ_BYTECODE = 16
+DEF baseline_callasm_BYTECODE = 8
+DEF baseline_add16_const_BYTECODE = 8
+DEF baseline_not_BYTECODE = 17
+DEF baseline_load16_const_BYTECODE = 18
+DEF baseline_store_const_BYTECODE = 37
+DEF baseline_add16_BYTECODE = 0
+DEF baseline_gte_BYTECODE = 19
+DEF baseline_goto_conditional_not_BYTECODE = 5
+DEF baseline_lor16_BYTECODE = 7
+DEF baseline_goto_conditional_BYTECODE = 4
+DEF baseline_lor_BYTECODE = 21
+DEF baseline_add_const_BYTECODE = 22
+DEF baseline_sub_const_BYTECODE = 23
+DEF baseline_lt_BYTECODE = 18
+DEF baseline_bor_const_BYTECODE = 27
+DEF baseline_not16_const_BYTECODE = 13
+DEF baseline_store16_const_BYTECODE = 19
+DEF baseline_store16_BYTECODE = 16
+DEF baseline_load16_BYTECODE = 15
+DEF baseline_sub16_BYTECODE = 1
+DEF baseline_sub16_const_BYTECODE = 9
+DEF baseline_band_const_BYTECODE = 26
+DEF baseline_mul16_BYTECODE = 2
+DEF baseline_equ16_BYTECODE = 4
+DEF baseline_equ16_const_BYTECODE = 12
+DEF baseline_div16_BYTECODE = 3
+DEF baseline_not16_BYTECODE = 5
+DEF baseline_bor_BYTECODE = 15
+DEF baseline_mul16_const_BYTECODE = 10
+DEF baseline_div16_const_BYTECODE = 11
+DEF std16_store16_const_BYTECODE = 19
+DEF std16_load16_const_BYTECODE = 18
+DEF std16_copy16_const_BYTECODE = 17
+DEF std16_store16_BYTECODE = 16
+DEF std16_load16_BYTECODE = 15
+DEF std16_copy16_BYTECODE = 14
+DEF std16_add16_BYTECODE = 0
+DEF std16_sub16_BYTECODE = 1
+DEF std16_sub16_const_BYTECODE = 9
+DEF std16_mul16_BYTECODE = 2
+DEF std16_equ16_BYTECODE = 4
+DEF std16_not16_const_BYTECODE = 13
+DEF std16_add16_const_BYTECODE = 8
+DEF std16_equ16_const_BYTECODE = 12
+DEF std16_div16_BYTECODE = 3
+DEF std16_not16_BYTECODE = 5
+DEF std16_land16_BYTECODE = 6
+DEF std16_lor16_BYTECODE = 7
+DEF std16_mul16_const_BYTECODE = 10
+DEF std16_div16_const_BYTECODE = 11
+DEF std_load_const_BYTECODE = 36
+DEF std_copy_const_BYTECODE = 35
+DEF std_load_BYTECODE = 33
+DEF std_lt_const_BYTECODE = 30
+DEF std_not_const_BYTECODE = 29
+DEF std_mul_BYTECODE = 12
+DEF std_add_BYTECODE = 10
+DEF std_goto_conditional_not_far_BYTECODE = 7
+DEF std_store_BYTECODE = 34
+DEF std_copy_BYTECODE = 32
+DEF std_goto_conditional_far_BYTECODE = 6
+DEF std_gte_const_BYTECODE = 31
+DEF std_sub_BYTECODE = 11
+DEF std_mul_const_BYTECODE = 24
+DEF std_land_BYTECODE = 20
+DEF std_goto_far_BYTECODE = 3
+DEF std_bor_BYTECODE = 15
+DEF std_store_const_BYTECODE = 37
+DEF std_callasm_far_BYTECODE = 9
+DEF std_goto_BYTECODE = 2
+DEF std_band_const_BYTECODE = 26
+DEF std_goto_conditional_BYTECODE = 4
+DEF std_sub_const_BYTECODE = 23
+DEF std_div_const_BYTECODE = 25
+DEF std_equ_const_BYTECODE = 28
+DEF std_yield_BYTECODE = 1
+DEF std_band_BYTECODE = 14
+DEF std_callasm_BYTECODE = 8
+DEF std_goto_conditional_not_BYTECODE = 5
+DEF std_return_BYTECODE = 0
+DEF std_div_BYTECODE = 13
+DEF std_equ_BYTECODE = 16
+DEF std_not_BYTECODE = 17
+DEF std_gte_BYTECODE = 19
+DEF std_lor_BYTECODE = 21
+DEF std_add_const_BYTECODE = 22
+DEF std_lt_BYTECODE = 18
+DEF std_bor_const_BYTECODE = 27
+
+SECTION "Branches evscript section", ROMX
+Branches::
+	; copy_const
+	db (35 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (5 >> 0) & 255
+
+	; copy_const
+	db (35 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (9 >> 0) & 255
+
+	; copy_const
+	db (35 >> 0) & 255
+	db (2 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	; mul
+	db (12 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+	; gte
+	db (19 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (3 >> 0) & 255
+
+	; goto_conditional_not
+	db (5 >> 0) & 255
+	db (3 >> 0) & 255
+
+	db (.__endif_0 >> 0) & 255
+	db (.__endif_0 >> 8) & 255
+
+	; sub
+	db (11 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+	; goto
+	db (2 >> 0) & 255
+	db (.__endelse_1 >> 0) & 255
+	db (.__endelse_1 >> 8) & 255
+
+.__endif_0
+	; sub
+	db (11 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+.__endelse_1
+	; equ_const
+	db (28 >> 0) & 255
+	db (2 >> 0) & 255
+
+	db (4 >> 0) & 255
+
+	db (3 >> 0) & 255
+
+	; goto_conditional_not
+	db (5 >> 0) & 255
+	db (3 >> 0) & 255
+
+	db (.__endif_2 >> 0) & 255
+	db (.__endif_2 >> 8) & 255
+
+	; face
+	db (59 >> 0) & 255
+	db (2 >> 0) & 255
+
+.__endif_2
+	; band_const
+	db (26 >> 0) & 255
+	db (2 >> 0) & 255
+
+	db (7 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+	; bor_const
+	db (27 >> 0) & 255
+	db (2 >> 0) & 255
+
+	db (16 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+	; div_const
+	db (25 >> 0) & 255
+	db (2 >> 0) & 255
+
+	db (3 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+	; store_const
+	db (37 >> 0) & 255
+	db (wGlobalVar >> 0) & 255
+	db (wGlobalVar >> 8) & 255
+
+	db (2 >> 0) & 255
+
+.__beginloop_3
+	; wait
+	db (58 >> 0) & 255
+	db (60 >> 0) & 255
+
+	; yield
+	db (1 >> 0) & 255
+	; goto
+	db (2 >> 0) & 255
+	db (.__beginloop_3 >> 0) & 255
+	db (.__beginloop_3 >> 8) & 255
+
+.__endloop_4
+
+SECTION "Loops evscript section", ROMX
+Loops::
+	; copy_const
+	db (35 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (3 >> 0) & 255
+
+	; load_const
+	db (36 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (wGlobalVar >> 0) & 255
+	db (wGlobalVar >> 8) & 255
+
+	; copy16_const
+	db (17 >> 0) & 255
+	db (2 >> 0) & 255
+	db (2 >> 8) & 255
+
+	db (1000 >> 0) & 255
+	db (1000 >> 8) & 255
+
+	; copy_const
+	db (35 >> 0) & 255
+	db (4 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+.__beginfor_0
+	; lt_const
+	db (30 >> 0) & 255
+	db (4 >> 0) & 255
+
+	db (10 >> 0) & 255
+
+	db (5 >> 0) & 255
+
+	; goto_conditional_not
+	db (5 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (.__endfor_1 >> 0) & 255
+	db (.__endfor_1 >> 8) & 255
+
+	; face
+	db (59 >> 0) & 255
+	db (4 >> 0) & 255
+
+	; add_const
+	db (22 >> 0) & 255
+	db (4 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (4 >> 0) & 255
+
+	; goto
+	db (2 >> 0) & 255
+	db (.__beginfor_0 >> 0) & 255
+	db (.__beginfor_0 >> 8) & 255
+
+.__endfor_1
+	; goto
+	db (2 >> 0) & 255
+	db (.__whilecondition_4 >> 0) & 255
+	db (.__whilecondition_4 >> 8) & 255
+
+.__beginwhile_2
+	; sub_const
+	db (23 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	; wait
+	db (58 >> 0) & 255
+	db (4 >> 0) & 255
+
+.__whilecondition_4
+	; not_const
+	db (29 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	db (5 >> 0) & 255
+
+	; goto_conditional
+	db (4 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (.__beginwhile_2 >> 0) & 255
+	db (.__beginwhile_2 >> 8) & 255
+
+.__endwhile_3
+.__begindo_5
+	; add
+	db (10 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	; add_const
+	db (22 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (2 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+.__docondition_7
+	; lt_const
+	db (30 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (12 >> 0) & 255
+
+	db (5 >> 0) & 255
+
+	; goto_conditional
+	db (4 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (.__begindo_5 >> 0) & 255
+	db (.__begindo_5 >> 8) & 255
+
+.__enddo_6
+	; copy_const
+	db (35 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (4 >> 0) & 255
+
+.__beginrepeat_8
+	; wait
+	db (58 >> 0) & 255
+	db (1 >> 0) & 255
+
+.__repeatcondition_9
+	; sub_const
+	db (23 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (5 >> 0) & 255
+
+	; goto_conditional
+	db (4 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (.__beginrepeat_8 >> 0) & 255
+	db (.__beginrepeat_8 >> 8) & 255
+
+.__endrepeat_10
+	; add16_const
+	db (8 >> 0) & 255
+	db (2 >> 0) & 255
+	db (2 >> 8) & 255
+
+	db (300 >> 0) & 255
+	db (300 >> 8) & 255
+
+	db (2 >> 0) & 255
+	db (2 >> 8) & 255
+
+	; copy_const
+	db (35 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+.__beginrepeat_11
+	; yield
+	db (1 >> 0) & 255
+.__repeatcondition_12
+	; sub_const
+	db (23 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (5 >> 0) & 255
+
+	; goto_conditional
+	db (4 >> 0) & 255
+	db (5 >> 0) & 255
+
+	db (.__beginrepeat_11 >> 0) & 255
+	db (.__beginrepeat_11 >> 8) & 255
+
+.__endrepeat_13
@@ -0,0 +1,191 @@
+; Generated by the evscript bytecode compiler, written by Eievui
+DEF std16_store16_const_BYTECODE = 19
+DEF std16_load16_const_BYTECODE = 18
+DEF std16_copy16_const_BYTECODE = 17
+DEF std16_store16_BYTECODE = 16
+DEF std16_load16_BYTECODE = 15
+DEF std16_copy16_BYTECODE = 14
+DEF std16_add16_BYTECODE = 0
+DEF std16_sub16_BYTECODE = 1
+DEF std16_sub16_const_BYTECODE = 9
+DEF std16_mul16_BYTECODE = 2
+DEF std16_equ16_BYTECODE = 4
+DEF std16_not16_const_BYTECODE = 13
+DEF std16_add16_const_BYTECODE = 8
+DEF std16_equ16_const_BYTECODE = 12
+DEF std16_div16_BYTECODE = 3
+DEF std16_not16_BYTECODE = 5
+DEF std16_land16_BYTECODE = 6
+DEF std16_lor16_BYTECODE = 7
+DEF std16_mul16_const_BYTECODE = 10
+DEF std16_div16_const_BYTECODE = 11
+DEF script_print_BYTECODE = 38
+DEF script_bor_const_BYTECODE = 27
+DEF script_lt_BYTECODE = 18
+DEF script_add_const_BYTECODE = 22
+DEF script_lor_BYTECODE = 21
+DEF script_gte_BYTECODE = 19
+DEF script_not_BYTECODE = 17
+DEF script_equ_BYTECODE = 16
+DEF script_div_BYTECODE = 13
+DEF script_mul_const_BYTECODE = 24
+DEF script_goto_conditional_far_BYTECODE = 6
+DEF script_copy_BYTECODE = 32
+DEF script_store_BYTECODE = 34
+DEF script_goto_conditional_not_far_BYTECODE = 7
+DEF script_add_BYTECODE = 10
+DEF script_mul_BYTECODE = 12
+DEF script_not_const_BYTECODE = 29
+DEF script_lt_const_BYTECODE = 30
+DEF script_load_BYTECODE = 33
+DEF script_yield_BYTECODE = 1
+DEF script_sub_BYTECODE = 11
+DEF script_gte_const_BYTECODE = 31
+DEF script_copy_const_BYTECODE = 35
+DEF script_load_const_BYTECODE = 36
+DEF script_land_BYTECODE = 20
+DEF script_goto_far_BYTECODE = 3
+DEF script_bor_BYTECODE = 15
+DEF script_callasm_far_BYTECODE = 9
+DEF script_store_const_BYTECODE = 37
+DEF script_goto_BYTECODE = 2
+DEF script_band_const_BYTECODE = 26
+DEF script_goto_conditional_BYTECODE = 4
+DEF script_sub_const_BYTECODE = 23
+DEF script_div_const_BYTECODE = 25
+DEF script_equ_const_BYTECODE = 28
+DEF script_band_BYTECODE = 14
+DEF script_return_BYTECODE = 0
+DEF script_callasm_BYTECODE = 8
+DEF script_goto_conditional_not_BYTECODE = 5
+DEF std_load_const_BYTECODE = 36
+DEF std_copy_const_BYTECODE = 35
+DEF std_load_BYTECODE = 33
+DEF std_lt_const_BYTECODE = 30
+DEF std_not_const_BYTECODE = 29
+DEF std_mul_BYTECODE = 12
+DEF std_add_BYTECODE = 10
+DEF std_goto_conditional_not_far_BYTECODE = 7
+DEF std_store_BYTECODE = 34
+DEF std_copy_BYTECODE = 32
+DEF std_goto_conditional_far_BYTECODE = 6
+DEF std_gte_const_BYTECODE = 31
+DEF std_sub_BYTECODE = 11
+DEF std_mul_const_BYTECODE = 24
+DEF std_land_BYTECODE = 20
+DEF std_goto_far_BYTECODE = 3
+DEF std_bor_BYTECODE = 15
+DEF std_store_const_BYTECODE = 37
+DEF std_callasm_far_BYTECODE = 9
+DEF std_goto_BYTECODE = 2
+DEF std_band_const_BYTECODE = 26
+DEF std_goto_conditional_BYTECODE = 4
+DEF std_sub_const_BYTECODE = 23
+DEF std_div_const_BYTECODE = 25
+DEF std_equ_const_BYTECODE = 28
+DEF std_yield_BYTECODE = 1
+DEF std_band_BYTECODE = 14
+DEF std_callasm_BYTECODE = 8
+DEF std_goto_conditional_not_BYTECODE = 5
+DEF std_return_BYTECODE = 0
+DEF std_div_BYTECODE = 13
+DEF std_equ_BYTECODE = 16
+DEF std_not_BYTECODE = 17
+DEF std_gte_BYTECODE = 19
+DEF std_lor_BYTECODE = 21
+DEF std_add_const_BYTECODE = 22
+DEF std_lt_BYTECODE = 18
+DEF std_bor_const_BYTECODE = 27
+
+SECTION "TestScript evscript section", ROMX
+TestScript::
+	; copy_const
+	db (35 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	; equ_const
+	db (28 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	; goto_conditional_not
+	db (5 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (.__endif_0 >> 0) & 255
+	db (.__endif_0 >> 8) & 255
+
+	; print
+	db (38 >> 0) & 255
+	db (.string_table0 >> 0) & 255
+	db (.string_table0 >> 8) & 255
+
+	; goto
+	db (2 >> 0) & 255
+	db (.__endelse_1 >> 0) & 255
+	db (.__endelse_1 >> 8) & 255
+
+.__endif_0
+	; print
+	db (38 >> 0) & 255
+	db (.string_table1 >> 0) & 255
+	db (.string_table1 >> 8) & 255
+
+.__endelse_1
+.__beginloop_2
+	; sub_const
+	db (23 >> 0) & 255
+	db (0 >> 0) & 255
+
+	db (4294967295 >> 0) & 255
+
+	db (0 >> 0) & 255
+
+	; store_const
+	db (37 >> 0) & 255
+	db (rBGP >> 0) & 255
+	db (rBGP >> 8) & 255
+
+	db (0 >> 0) & 255
+
+	; copy_const
+	db (35 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (8 >> 0) & 255
+
+.__beginrepeat_4
+	; yield
+	db (1 >> 0) & 255
+.__repeatcondition_5
+	; sub_const
+	db (23 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	db (1 >> 0) & 255
+
+	; goto_conditional
+	db (4 >> 0) & 255
+	db (1 >> 0) & 255
+
+	db (.__beginrepeat_4 >> 0) & 255
+	db (.__beginrepeat_4 >> 8) & 255
+
+.__endrepeat_6
+	; goto
+	db (2 >> 0) & 255
+	db (.__beginloop_2 >> 0) & 255
+	db (.__beginloop_2 >> 8) & 255
+
+.__endloop_3
+.string_table0
+db "Hello, world!", 0
+.string_table1
+db "Where am I?", 0
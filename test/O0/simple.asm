@@ -0,0 +1,72 @@
+; Generated by the evscript bytecode compiler, written by Eievui
+DEF example_debug_BYTECODE = 1
+DEF example_ret_BYTECODE = 0
+DEF std16_store16_const_BYTECODE = 19
+DEF std16_load16_const_BYTECODE = 18
+DEF std16_copy16_const_BYTECODE = 17
+DEF std16_store16_BYTECODE = 16
+DEF std16_load16_BYTECODE = 15
+DEF std16_copy16_BYTECODE = 14
+DEF std16_add16_BYTECODE = 0
+DEF std16_sub16_BYTECODE = 1
+DEF std16_sub16_const_BYTECODE = 9
+DEF std16_mul16_BYTECODE = 2
+DEF std16_equ16_BYTECODE = 4
+DEF std16_not16_const_BYTECODE = 13
+DEF std16_add16_const_BYTECODE = 8
+DEF std16_equ16_const_BYTECODE = 12
+DEF std16_div16_BYTECODE = 3
+DEF std16_not16_BYTECODE = 5
+DEF std16_land16_BYTECODE = 6
+DEF std16_lor16_BYTECODE = 7
+DEF std16_mul16_const_BYTECODE = 10
+DEF std16_div16_const_BYTECODE = 11
+DEF std_load_const_BYTECODE = 36
+DEF std_copy_const_BYTECODE = 35
+DEF std_load_BYTECODE = 33
+DEF std_lt_const_BYTECODE = 30
+DEF std_not_const_BYTECODE = 29
+DEF std_mul_BYTECODE = 12
+DEF std_add_BYTECODE = 10
+DEF std_goto_conditional_not_far_BYTECODE = 7
+DEF std_store_BYTECODE = 34
+DEF std_copy_BYTECODE = 32
+DEF std_goto_conditional_far_BYTECODE = 6
+DEF std_gte_const_BYTECODE = 31
+DEF std_sub_BYTECODE = 11
+DEF std_mul_const_BYTECODE = 24
+DEF std_land_BYTECODE = 20
+DEF std_goto_far_BYTECODE = 3
+DEF std_bor_BYTECODE = 15
+DEF std_store_const_BYTECODE = 37
+DEF std_callasm_far_BYTECODE = 9
+DEF std_goto_BYTECODE = 2
+DEF std_band_const_BYTECODE = 26
+DEF std_goto_conditional_BYTECODE = 4
+DEF std_sub_const_BYTECODE = 23
+DEF std_div_const_BYTECODE = 25
+DEF std_equ_const_BYTECODE = 28
+DEF std_yield_BYTECODE = 1
+DEF std_band_BYTECODE = 14
+DEF std_callasm_BYTECODE = 8
+DEF std_goto_conditional_not_BYTECODE = 5
+DEF std_return_BYTECODE = 0
+DEF std_div_BYTECODE = 13
+DEF std_equ_BYTECODE = 16
+DEF std_not_BYTECODE = 17
+DEF std_gte_BYTECODE = 19
+DEF std_lor_BYTECODE = 21
+DEF std_add_const_BYTECODE = 22
+DEF std_lt_BYTECODE = 18
+DEF std_bor_const_BYTECODE = 27
+
+SECTION "Debug evscript section", ROMX
+Debug::
+	; debug
+	db (1 >> 0) & 255
+	db (.string_table0 >> 0) & 255
+	db (.string_table0 >> 8) & 255
+
+	db (0 >> 0) & 255
+.string_table0
+db "Hello, world!", 0
@@ -0,0 +1,52 @@
+#!/bin/sh
+# Compile each example at every optimization level, run it on the host, and
+# check that -Os and -O2 do the same things as -O0. The examples are also
+# compiled with compressed text, whose strings the host decodes as the runtime
+# would, so they should be traced exactly as written.
+#
+# O0/ holds the output of the original compiler for the scripts it could
+# compile, which -O0 should still produce. Since then, std has gained
+# functions, so opcodes are compared by name rather than number.
+set -e
+cd "$(dirname "$0")"
+EVSCRIPT=${EVSCRIPT:-../bin/evscript}
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+
+# Replace each opcode's number with the name in the comment above it, and drop
+# the definitions of the numbers.
+opcodes() {
+	awk '/^DEF / { next } previous ~ /^\t; / && /^\tdb \(/ { sub(/\([0-9]+ >>/, "(" substr(previous, 4) " >>") } { print; previous = $0 }' "$1"
+}
+
+status=0
+for input in ../examples/simple.evs ../examples/spec.evs script.evs baseline.evs levels.evs; do
+	name=$(basename "$input" .evs)
+	for level in 0 s 2; do
+		"$EVSCRIPT" -O$level -o "$out/$name-O$level.asm" --host-trace="$out/$name-O$level.trace" "$input"
+	done
+	if [ -f "O0/$name.asm" ]; then
+		opcodes "O0/$name.asm" > "$out/$name-expected.asm"
+		opcodes "$out/$name-O0.asm" > "$out/$name-actual.asm"
+		if ! diff -u "$out/$name-expected.asm" "$out/$name-actual.asm" > "$out/$name-asm.diff"; then
+			echo "$input: -O0 differs from O0/$name.asm:"
+			head -n 20 "$out/$name-asm.diff"
+			status=1
+		fi
+	fi
+	# Native scripts are entered using exec_native, which must be kept in a
+	# generated table even though no bytecode refers to it.
+	if grep -q "^native" "$input" && ! grep -q "dw StdExecNative" "$out/$name-O0.asm"; then
+		echo "$input: exec_native is missing from the bytecode table"
+		status=1
+	fi
+	"$EVSCRIPT" --string-pool=ROM0 --compress-text -o "$out/$name-text.asm" --host-trace="$out/$name-text.trace" "$input"
+	for build in Os O2 text; do
+		if ! diff -u "$out/$name-O0.trace" "$out/$name-$build.trace" > "$out/$name-$build.diff"; then
+			echo "$input: the $build build behaves differently from -O0:"
+			head -n 20 "$out/$name-$build.diff"
+			status=1
+		fi
+	done
+done
+exit $status